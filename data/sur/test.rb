@@ -172,6 +172,42 @@ module Subtle # {{{
           @data = data
         end # }}}
 
+        ## Subtle::Sur::Test::Sublet::template= {{{
+        # Set the template of a Sublet with numbered slots
+        #
+        # @param [String]  template  Sublet template
+        #
+        # @raise [String] Sublet error
+        # @since 0.0
+        #
+        # @example
+        #   Subtle::Sublet.new.template = "CPU: ^$1^%"
+        #   => nil
+
+        def template=(template)
+          raise ArgumentError.new("Unknown value type") unless template.is_a?(String)
+          @template = template
+          @data     = template.gsub(/\^\$[0-9]+\^/, "")
+        end # }}}
+
+        ## Subtle::Sur::Test::Sublet::slots= {{{
+        # Set the slot values of a Sublet template
+        #
+        # @param [Array]  slots  Slot values
+        #
+        # @since 0.0
+        #
+        # @example
+        #   Subtle::Sublet.new.slots = [ 42 ]
+        #   => nil
+
+        def slots=(slots)
+          slots = [ slots ] unless slots.is_a?(Array)
+          @data = (@template || "").gsub(/\^\$([0-9]+)\^/) do
+            slots[$1.to_i - 1].to_s
+          end
+        end # }}}
+
         ## Subtle::Sur::Test::Sublet::background= {{{
         # Set the background of a Sublet
         #
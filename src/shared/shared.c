@@ -12,10 +12,472 @@
 
 #include "shared.h"
 #include <ctype.h>
+#include <limits.h>
 #include <signal.h>
 #include <sys/time.h>
 #include <unistd.h>
 
+/* Color cache */
+
+#define SHARED_SPECS 128 ///< Number of cached color specs
+#define SHARED_SPECS_LENGTH 32 ///< Max length of cached color specs
+#define SHARED_PIXELS 64 ///< Number of cached pixel colors
+
+typedef struct sharedspec_t { /* {{{ */
+    char name[SHARED_SPECS_LENGTH]; ///< Color spec
+    unsigned long pixel; ///< Color pixel
+} SharedSpec; /* }}} */
+
+static SharedSpec specs[SHARED_SPECS];
+static XColor pixels[SHARED_PIXELS]; ///< Flags are zero when unused
+static int truecolor = -1, shifts[3], bits[3];
+
+/* SharedColorVisual {{{ */
+static int SharedColorVisual(Display *disp) {
+    /* Check default visual once */
+    if (-1 == truecolor) {
+        int i;
+        Visual *visual = DefaultVisual(disp, DefaultScreen(disp));
+        unsigned long masks[3] = {visual->red_mask, visual->green_mask, visual->blue_mask};
+
+        truecolor = (TrueColor == visual->class);
+
+        /* Get channel layout from masks */
+        for (i = 0; truecolor && i < 3; i++) {
+            shifts[i] = bits[i] = 0;
+
+            while (masks[i] && !(masks[i] & 1)) {
+                masks[i] >>= 1;
+                shifts[i]++;
+            }
+            while (masks[i] & 1) {
+                masks[i] >>= 1;
+                bits[i]++;
+            }
+
+            if (0 == bits[i] || 16 < bits[i]) {
+                truecolor = False;
+            }
+        }
+    }
+
+    return truecolor;
+} /* }}} */
+
+/* SharedColorToPixel {{{ */
+static void SharedColorToPixel(XColor *xcolor) {
+    unsigned short rgb[3] = {xcolor->red, xcolor->green, xcolor->blue};
+    int i;
+
+    /* Keep upper bits of each channel */
+    for (i = 0, xcolor->pixel = 0; i < 3; i++) {
+        xcolor->pixel |= (unsigned long) (rgb[i] >> (16 - bits[i])) << shifts[i];
+    }
+} /* }}} */
+
+/* SharedColorToRGB {{{ */
+static void SharedColorToRGB(XColor *xcolor) {
+    unsigned short *rgb[3] = {&xcolor->red, &xcolor->green, &xcolor->blue};
+    int i;
+
+    /* Scale each channel to 65535 */
+    for (i = 0; i < 3; i++) {
+        unsigned long max = (1UL << bits[i]) - 1;
+
+        *rgb[i] = ((xcolor->pixel >> shifts[i]) & max) * 65535 / max;
+    }
+
+    xcolor->flags = DoRed | DoGreen | DoBlue;
+} /* }}} */
+
+#ifdef HAVE_X11_XFT_XFT_H
+/* Xft cache */
+
+#define SHARED_COLORS 64 ///< Number of cached Xft colors
+#define SHARED_DRAWS 256 ///< Max number of cached Xft draws
+
+typedef struct shareddraw_t { /* {{{ */
+    Drawable drawable; ///< Draw target
+    XftDraw *draw; ///< Draw handle
+    unsigned long used; ///< Draw last use
+} SharedDraw; /* }}} */
+
+static XftColor colors[SHARED_COLORS]; ///< Alpha is zero when unused
+static SharedDraw *draws = NULL; ///< Open addressed by drawable
+static int ndraws = 0, sdraws = 0;
+static unsigned long used = 0;
+
+/* SharedColorStore {{{ */
+static XftColor *SharedColorStore(XColor *xcolor) {
+    XftColor *color = &colors[xcolor->pixel % SHARED_COLORS];
+
+    color->pixel = xcolor->pixel;
+    color->color.red = xcolor->red;
+    color->color.green = xcolor->green;
+    color->color.blue = xcolor->blue;
+    color->color.alpha = 0xffff;
+
+    return color;
+} /* }}} */
+
+/* SharedColorFind {{{ */
+static XftColor *SharedColorFind(Display *disp, unsigned long pixel) {
+    XftColor *color = &colors[pixel % SHARED_COLORS];
+
+    /* Query unknown pixel once */
+    if (0 == color->color.alpha || color->pixel != pixel) {
+        XColor xcolor = {0};
+
+        xcolor.pixel = pixel;
+        subSharedColorQuery(disp, &xcolor);
+
+        color = SharedColorStore(&xcolor);
+    }
+
+    return color;
+} /* }}} */
+
+/* SharedDrawSlot {{{ */
+static int SharedDrawSlot(Drawable drawable) {
+    return (int) ((drawable * 2654435761UL) & (sdraws - 1));
+} /* }}} */
+
+/* SharedDrawLookup {{{ */
+static int SharedDrawLookup(Drawable drawable) {
+    int i;
+
+    if (0 == sdraws) return -1;
+
+    /* Probe until an empty slot */
+    for (i = SharedDrawSlot(drawable); draws[i].draw; i = (i + 1) & (sdraws - 1)) {
+        if (draws[i].drawable == drawable) return i;
+    }
+
+    return -1;
+} /* }}} */
+
+/* SharedDrawRemove {{{ */
+static void SharedDrawRemove(int i) {
+    int j, k;
+
+    XftDrawDestroy(draws[i].draw);
+
+    draws[i].draw = NULL;
+    ndraws--;
+
+    /* Shift following entries back into the hole */
+    for (j = (i + 1) & (sdraws - 1); draws[j].draw; j = (j + 1) & (sdraws - 1)) {
+        k = SharedDrawSlot(draws[j].drawable);
+
+        if ((i < j && (k <= i || j < k)) || (j < i && k <= i && j < k)) {
+            draws[i] = draws[j];
+            draws[j].draw = NULL;
+            i = j;
+        }
+    }
+} /* }}} */
+
+/* SharedDrawInsert {{{ */
+static SharedDraw *SharedDrawInsert(Drawable drawable, XftDraw *draw) {
+    int i;
+
+    /* Grow table to keep it half empty */
+    if (2 * (ndraws + 1) > sdraws && sdraws < 2 * SHARED_DRAWS) {
+        int osize = sdraws;
+        SharedDraw *old = draws;
+
+        sdraws = sdraws ? 2 * sdraws : 16;
+        draws = (SharedDraw *) subSharedMemoryAlloc(sdraws, sizeof(SharedDraw));
+
+        for (i = 0; i < osize; i++) {
+            if (old[i].draw) {
+                int j = SharedDrawSlot(old[i].drawable);
+
+                while (draws[j].draw) j = (j + 1) & (sdraws - 1);
+
+                draws[j] = old[i];
+            }
+        }
+
+        if (old) free(old);
+    }
+
+    /* Evict least recently used one when full */
+    if (ndraws == SHARED_DRAWS) {
+        int lru = -1;
+
+        for (i = 0; i < sdraws; i++) {
+            if (draws[i].draw && (-1 == lru || draws[i].used < draws[lru].used)) {
+                lru = i;
+            }
+        }
+
+        SharedDrawRemove(lru);
+    }
+
+    for (i = SharedDrawSlot(drawable); draws[i].draw; i = (i + 1) & (sdraws - 1));
+
+    draws[i].drawable = drawable;
+    draws[i].draw = draw;
+    ndraws++;
+
+    return &draws[i];
+} /* }}} */
+
+/* SharedDrawFind {{{ */
+static XftDraw *SharedDrawFind(Display *disp, Drawable drawable) {
+    int i;
+    SharedDraw *d = NULL;
+
+    /* Owners forget their drawables, so this only evicts on leaks */
+    if (-1 != (i = SharedDrawLookup(drawable))) {
+        d = &draws[i];
+    } else {
+        d = SharedDrawInsert(drawable, XftDrawCreate(disp, drawable,
+                                                     DefaultVisual(disp, DefaultScreen(disp)),
+                                                     DefaultColormap(disp, DefaultScreen(disp))));
+    }
+
+    d->used = ++used;
+
+    return d->draw;
+} /* }}} */
+#endif /* HAVE_X11_XFT_XFT_H */
+
+/* Width cache */
+
+#define SHARED_WIDTHS 256 ///< Number of cached string widths
+#define SHARED_WIDTHS_BUCKETS 509 ///< Number of width cache buckets
+#define SHARED_WIDTHS_LENGTH 64 ///< Max length of cached strings
+
+typedef struct sharedwidth_t { /* {{{ */
+    SubFont *f; ///< Width font
+    unsigned long hash; ///< Width hash of font and text
+    int len, width, lbearing; ///< Width text length, width and left bearing
+    int newer, older, chain; ///< Width LRU neighbours and bucket chain (index + 1)
+    char text[SHARED_WIDTHS_LENGTH]; ///< Width text
+} SharedWidth; /* }}} */
+
+static SharedWidth widths[SHARED_WIDTHS];
+static int buckets[SHARED_WIDTHS_BUCKETS], nwidths = 0, newest = 0, oldest = 0;
+static unsigned long hits = 0, misses = 0;
+
+/* SharedWidthUnlink {{{ */
+static void SharedWidthUnlink(int idx) {
+    SharedWidth *w = &widths[idx - 1];
+
+    if (w->newer) {
+        widths[w->newer - 1].older = w->older;
+    } else {
+        newest = w->older;
+    }
+
+    if (w->older) {
+        widths[w->older - 1].newer = w->newer;
+    } else {
+        oldest = w->newer;
+    }
+
+    w->newer = w->older = 0;
+} /* }}} */
+
+/* SharedWidthLink {{{ */
+static void SharedWidthLink(int idx) {
+    SharedWidth *w = &widths[idx - 1];
+
+    w->older = newest;
+    w->newer = 0;
+
+    if (newest) {
+        widths[newest - 1].newer = idx;
+    }
+
+    newest = idx;
+
+    if (!oldest) {
+        oldest = idx;
+    }
+} /* }}} */
+
+#ifdef HAVE_X11_XFT_XFT_H
+#define SHARED_GLYPH_UNKNOWN SHRT_MIN ///< Glyph not loaded yet
+#define SHARED_GLYPH_MISSING (SHRT_MIN + 1) ///< Glyph not in font
+
+/* SharedGlyph {{{ */
+static short *SharedGlyph(Display *disp, SubFont *f, unsigned int ucs) {
+    short *page = NULL;
+
+    /* Load pages of 256 glyphs on demand */
+    if (!f->glyphs) {
+        f->glyphs = (short **) subSharedMemoryAlloc(256, sizeof(short *));
+    }
+
+    if (!(page = f->glyphs[ucs >> 8])) {
+        int i;
+
+        page = f->glyphs[ucs >> 8] = (short *) subSharedMemoryAlloc(2 * 256, sizeof(short));
+
+        for (i = 0; i < 256; i++) {
+            page[2 * i + 1] = SHARED_GLYPH_UNKNOWN;
+        }
+    }
+
+    page += 2 * (ucs & 0xff);
+
+    /* Query glyph metrics once */
+    if (SHARED_GLYPH_UNKNOWN == page[1]) {
+        FT_UInt glyph = XftCharIndex(disp, f->xft, ucs);
+
+        if (glyph) {
+            XGlyphInfo info;
+
+            XftGlyphExtents(disp, f->xft, &glyph, 1, &info);
+
+            page[0] = info.x;
+            page[1] = info.xOff;
+        } else {
+            page[1] = SHARED_GLYPH_MISSING;
+        }
+    }
+
+    return page;
+} /* }}} */
+
+/* SharedGlyphMeasure {{{ */
+static int SharedGlyphMeasure(Display *disp, SubFont *f, const char *text, int len, int *width,
+                              int *lbearing)
+{
+    int i = 0, x = 0, left = INT_MAX;
+    const unsigned char *str = (const unsigned char *) text;
+
+    /* Sum advances like Xft does, it doesn't kern */
+    while (i < len) {
+        unsigned int ucs = str[i];
+        short *glyph = NULL;
+
+        /* Decode UTF-8 of the BMP */
+        if (0x80 > ucs) {
+            i++;
+        } else if (0xc0 == (ucs & 0xe0) && i + 1 < len && 0x80 == (str[i + 1] & 0xc0)) {
+            ucs = ((ucs & 0x1f) << 6) | (str[i + 1] & 0x3f);
+            i += 2;
+        } else if (0xe0 == (ucs & 0xf0) && i + 2 < len && 0x80 == (str[i + 1] & 0xc0) &&
+                   0x80 == (str[i + 2] & 0xc0)) {
+            ucs = ((ucs & 0x0f) << 12) | ((str[i + 1] & 0x3f) << 6) | (str[i + 2] & 0x3f);
+            i += 3;
+        } else {
+            return False; ///< Let Xft handle anything else
+        }
+
+        if (SHARED_GLYPH_MISSING == (glyph = SharedGlyph(disp, f, ucs))[1]) {
+            return False;
+        }
+
+        if (x - glyph[0] < left) {
+            left = x - glyph[0];
+        }
+
+        x += glyph[1];
+    }
+
+    *width = x;
+    *lbearing = -left;
+
+    return True;
+} /* }}} */
+#endif /* HAVE_X11_XFT_XFT_H */
+
+/* SharedWidthMeasure {{{ */
+static void SharedWidthMeasure(Display *disp, SubFont *f, const char *text, int len, int *width,
+                               int *lbearing)
+{
+#ifdef HAVE_X11_XFT_XFT_H
+    if (f->xft) { ///< XFT
+        XGlyphInfo extents;
+
+        /* Prefer glyph tables */
+        if (SharedGlyphMeasure(disp, f, text, len, width, lbearing)) {
+            return;
+        }
+
+        XftTextExtentsUtf8(disp, f->xft, (XftChar8 *) text, len, &extents);
+
+        *width = extents.xOff;
+        *lbearing = extents.x;
+    } else ///< XFS
+#endif /* HAVE_X11_XFT_XFT_H */
+    {
+        XRectangle overall_ink = {0}, overall_logical = {0};
+
+        XmbTextExtents(f->xfs, text, len, &overall_ink, &overall_logical);
+
+        *width = overall_logical.width;
+        *lbearing = overall_logical.x;
+    }
+} /* }}} */
+
+/* SharedWidthFind {{{ */
+static SharedWidth *SharedWidthFind(SubFont *f, const char *text, int len, unsigned long hash) {
+    int idx;
+
+    for (idx = buckets[hash % SHARED_WIDTHS_BUCKETS]; idx; idx = widths[idx - 1].chain) {
+        SharedWidth *w = &widths[idx - 1];
+
+        if (w->hash == hash && w->f == f && w->len == len && 0 == memcmp(w->text, text, len)) {
+            /* Move to front */
+            if (newest != idx) {
+                SharedWidthUnlink(idx);
+                SharedWidthLink(idx);
+            }
+
+            return w;
+        }
+    }
+
+    return NULL;
+} /* }}} */
+
+/* SharedWidthStore {{{ */
+static void SharedWidthStore(SubFont *f, const char *text, int len, unsigned long hash,
+                             int width, int lbearing)
+{
+    int idx, *link = NULL;
+    SharedWidth *w = NULL;
+
+    /* Take free slot or evict least recently used */
+    if (SHARED_WIDTHS > nwidths) {
+        idx = ++nwidths;
+    } else {
+        idx = oldest;
+        w = &widths[idx - 1];
+
+        /* Remove from bucket chain */
+        link = &buckets[w->hash % SHARED_WIDTHS_BUCKETS];
+
+        while (*link != idx) {
+            link = &widths[*link - 1].chain;
+        }
+
+        *link = w->chain;
+
+        SharedWidthUnlink(idx);
+    }
+
+    w = &widths[idx - 1];
+    w->f = f;
+    w->hash = hash;
+    w->len = len;
+    w->width = width;
+    w->lbearing = lbearing;
+    w->chain = buckets[hash % SHARED_WIDTHS_BUCKETS];
+
+    memcpy(w->text, text, len);
+
+    buckets[hash % SHARED_WIDTHS_BUCKETS] = idx;
+
+    SharedWidthLink(idx);
+} /* }}} */
+
 /* Memory */
 
 /** subSharedMemoryAlloc {{{
@@ -346,21 +808,8 @@ void subSharedDrawString(Display *disp, GC gc, SubFont *f, Window win, int x, in
     /* Draw text */
 #ifdef HAVE_X11_XFT_XFT_H
     if (f->xft) { ///< XFT
-        XftColor color = {0};
-        XColor xcolor = {0};
-
-        /* Get color values */
-        xcolor.pixel = fg;
-        XQueryColor(disp, DefaultColormap(disp, DefaultScreen(disp)), &xcolor);
-
-        color.pixel = xcolor.pixel;
-        color.color.red = xcolor.red;
-        color.color.green = xcolor.green;
-        color.color.blue = xcolor.blue;
-        color.color.alpha = 0xffff;
-
-        XftDrawChange(f->draw, win);
-        XftDrawStringUtf8(f->draw, &color, f->xft, x, y, (XftChar8 *) text, len);
+        XftDrawStringUtf8(SharedDrawFind(disp, win), SharedColorFind(disp, fg), f->xft, x, y,
+                          (XftChar8 *) text, len);
     } else ///< XFS
 #endif /* HAVE_X11_XFT_XFT_H */
     {
@@ -373,6 +822,22 @@ void subSharedDrawString(Display *disp, GC gc, SubFont *f, Window win, int x, in
     }
 } /* }}} */
 
+/** subSharedDrawForget {{{
+ * @brief Drop cached draw handle of drawable before it is freed
+ * @param[in]  disp      Display
+ * @param[in]  drawable  Drawable
+ **/
+
+void subSharedDrawForget(Display *disp, Drawable drawable) {
+#ifdef HAVE_X11_XFT_XFT_H
+    int i;
+
+    if (-1 != (i = SharedDrawLookup(drawable))) {
+        SharedDrawRemove(i);
+    }
+#endif /* HAVE_X11_XFT_XFT_H */
+} /* }}} */
+
 /** subSharedDrawIcon {{{
  * @brief Draw text
  * @param[in]  disp    Display
@@ -431,9 +896,6 @@ SubFont *subSharedFontNew(Display *disp, const char *name) {
             /* Create new font */
             f = FONT(subSharedMemoryAlloc(1, sizeof(SubFont)));
             f->xft = xft;
-            f->draw = XftDrawCreate(disp, DefaultRootWindow(disp),
-                                    DefaultVisual(disp, DefaultScreen(disp)),
-                                    DefaultColormap(disp, DefaultScreen(disp)));
 
             /* Font metrics */
             f->height = f->xft->ascent + f->xft->descent + 2;
@@ -476,10 +938,26 @@ SubFont *subSharedFontNew(Display *disp, const char *name) {
 void subSharedFontKill(Display *disp, SubFont *f) {
     assert(f);
 
+    /* Drop cached widths, font address may be reused */
+    memset(buckets, 0, sizeof(buckets));
+    nwidths = newest = oldest = 0;
+
 #ifdef HAVE_X11_XFT_XFT_H
     if (f->xft) {
         XftFontClose(disp, f->xft);
-        XftDrawDestroy(f->draw);
+
+        /* Free glyph pages */
+        if (f->glyphs) {
+            int i;
+
+            for (i = 0; i < 256; i++) {
+                if (f->glyphs[i]) {
+                    free(f->glyphs[i]);
+                }
+            }
+
+            free(f->glyphs);
+        }
     } else
 #endif /* HAVE_X11_XFT_XFT_H */
     {
@@ -491,6 +969,90 @@ void subSharedFontKill(Display *disp, SubFont *f) {
 
 /* Misc */
 
+/** subSharedColorAlloc {{{
+ * @brief Allocate color from rgb values
+ * @param[in]     disp    Display
+ * @param[inout]  xcolor  Color to allocate
+ * @return Returns \p True on success
+ **/
+
+int subSharedColorAlloc(Display *disp, XColor *xcolor) {
+    XColor *cached = NULL;
+
+    assert(xcolor);
+
+    /* Compute pixel locally without round trip */
+    if (SharedColorVisual(disp)) {
+        SharedColorToPixel(xcolor);
+        SharedColorToRGB(xcolor);
+
+        return True;
+    }
+
+    if (!XAllocColor(disp, DefaultColormap(disp, DefaultScreen(disp)), xcolor)) {
+        return False;
+    }
+
+    /* Spare query of this pixel */
+    cached = &pixels[xcolor->pixel % SHARED_PIXELS];
+    *cached = *xcolor;
+    cached->flags = DoRed | DoGreen | DoBlue;
+
+    return True;
+} /* }}} */
+
+/** subSharedColorQuery {{{
+ * @brief Get rgb values of color pixel
+ * @param[in]     disp    Display
+ * @param[inout]  xcolor  Color with pixel to fill
+ **/
+
+void subSharedColorQuery(Display *disp, XColor *xcolor) {
+    XColor *cached = NULL;
+
+    assert(xcolor);
+
+    /* Compute rgb locally without round trip */
+    if (SharedColorVisual(disp)) {
+        SharedColorToRGB(xcolor);
+
+        return;
+    }
+
+    /* Query unknown pixel once */
+    cached = &pixels[xcolor->pixel % SHARED_PIXELS];
+
+    if (0 == cached->flags || cached->pixel != xcolor->pixel) {
+        cached->pixel = xcolor->pixel;
+
+        XQueryColor(disp, DefaultColormap(disp, DefaultScreen(disp)), cached);
+        cached->flags = DoRed | DoGreen | DoBlue;
+    }
+
+    *xcolor = *cached;
+} /* }}} */
+
+/** subSharedHash {{{
+ * @brief Hash data with FNV-1a
+ * @param[in]  hash  Hash to continue or \p 0
+ * @param[in]  data  Data to hash
+ * @param[in]  len   Length of data
+ * @return Updated hash value
+ **/
+
+unsigned long subSharedHash(unsigned long hash, const void *data, size_t len) {
+    size_t i;
+    const unsigned char *bytes = (const unsigned char *) data;
+
+    if (0 == hash) hash = 2166136261UL; ///< Offset basis
+
+    for (i = 0; i < len; i++) {
+        hash = (hash ^ bytes[i]) * 16777619UL;
+    }
+
+    return hash;
+} /* }}} */
+
 /** subSharedParseColor {{{
  * @brief Parse and load color
  * @param[in]  disp  Display
@@ -499,15 +1061,36 @@ void subSharedFontKill(Display *disp, SubFont *f) {
  **/
 
 unsigned long subSharedParseColor(Display *disp, char *name) {
+    size_t len = 0;
     XColor xcolor = {0}; ///< Default color
+    SharedSpec *spec = NULL;
 
     assert(name);
 
+    /* Check spec cache */
+    if ((len = strlen(name)) < SHARED_SPECS_LENGTH) {
+        spec = &specs[subSharedHash(0, name, len) % SHARED_SPECS];
+
+        if ('\0' != spec->name[0] && 0 == strcmp(spec->name, name)) {
+            return spec->pixel;
+        }
+    }
+
     /* Parse and store color */
     if (!XParseColor(disp, DefaultColormap(disp, DefaultScreen(disp)), name, &xcolor)) {
         fprintf(stderr, "<CRITICAL> Failed loading color `%s'\n", name);
-    } else if (!XAllocColor(disp, DefaultColormap(disp, DefaultScreen(disp)), &xcolor))
+    } else if (!subSharedColorAlloc(disp, &xcolor)) {
         fprintf(stderr, "<CRITICAL> Failed allocating color `%s'\n", name);
+    } else {
+        if (spec) {
+            memcpy(spec->name, name, len + 1);
+            spec->pixel = xcolor.pixel;
+        }
+
+#ifdef HAVE_X11_XFT_XFT_H
+        SharedColorStore(&xcolor); ///< Spare query when drawing
+#endif /* HAVE_X11_XFT_XFT_H */
+    }
 
     return xcolor.pixel;
 } /* }}} */
@@ -625,28 +1208,32 @@ int subSharedStringWidth(Display *disp, SubFont *f, const char *text, int len, i
                          int *right, int center)
 {
     int width = 0, lbearing = 0, rbearing = 0;
+    unsigned long hash = 0;
+    SharedWidth *w = NULL;
 
     assert(f);
 
     /* Get text extents based on font */
     if (text && 0 < len) {
-#ifdef HAVE_X11_XFT_XFT_H
-        if (f->xft) { ///< XFT
-            XGlyphInfo extents;
+        /* Cache widths of short strings only */
+        if (SHARED_WIDTHS_LENGTH >= len) {
+            hash = subSharedHash(subSharedHash(0, &f, sizeof(f)), text, len);
+            w = SharedWidthFind(f, text, len, hash);
+        }
 
-            XftTextExtentsUtf8(disp, f->xft, (XftChar8 *) text, len, &extents);
+        if (w) {
+            width = w->width;
+            lbearing = w->lbearing;
 
-            width = extents.xOff;
-            lbearing = extents.x;
-        } else ///< XFS
-#endif /* HAVE_X11_XFT_XFT_H */
-        {
-            XRectangle overall_ink = {0}, overall_logical = {0};
+            hits++;
+        } else {
+            SharedWidthMeasure(disp, f, text, len, &width, &lbearing);
 
-            XmbTextExtents(f->xfs, text, len, &overall_ink, &overall_logical);
+            if (SHARED_WIDTHS_LENGTH >= len) {
+                SharedWidthStore(f, text, len, hash, width, lbearing);
 
-            width = overall_logical.width;
-            lbearing = overall_logical.x;
+                misses++;
+            }
         }
 
         /* Get left and right spacing */
@@ -661,6 +1248,21 @@ int subSharedStringWidth(Display *disp, SubFont *f, const char *text, int len, i
     return center ? width - abs(lbearing - rbearing) : width;
 } /* }}} */
 
+/** subSharedStringWidthStats {{{
+ * @brief Get hits and misses of the width cache
+ * @param[out]  nhits    Number of hits
+ * @param[out]  nmisses  Number of misses
+ **/
+
+void subSharedStringWidthStats(unsigned long *nhits, unsigned long *nmisses) {
+    if (nhits) {
+        *nhits = hits;
+    }
+    if (nmisses) {
+        *nmisses = misses;
+    }
+} /* }}} */
+
 #ifndef SUBTLE
 
 /** subSharedMessage {{{
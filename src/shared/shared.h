@@ -46,6 +46,7 @@
            r.width, r.height); ///< Print a XRectangle
 
 #define DEFFONT "-*-*-*-*-*-*-14-*-*-*-*-*-*-*" ///< Default font
+#define TAGSWORDS 8 ///< Words per tag set
 
 #define DATA(d) ((SubData) d) ///< Cast to SubData
 #define FONT(f) ((SubFont *) f) ///< Cast to SubFont
@@ -97,7 +98,7 @@ typedef struct subfont_t /* {{{ */
 
 #ifdef HAVE_X11_XFT_XFT_H
     XftFont *xft; ///< Font XFT font
-    XftDraw *draw; ///< Font XFT draw
+    short **glyphs; ///< Font XFT glyph bearing and advance pages
 #endif /* HAVE_X11_XFT_XFT_H */
 } SubFont; /* }}} */
 
@@ -142,6 +143,7 @@ void subSharedDrawIcon(Display *disp, GC gc, Window win, int x, int y, int width
                        long fg, long bg, Pixmap pixmap, int bitmap); ///< Draw icons
 void subSharedDrawString(Display *disp, GC gc, SubFont *f, Window win, int x, int y, long fg,
                          long bg, const char *text, int len); ///< Draw text
+void subSharedDrawForget(Display *disp, Drawable drawable); ///< Forget drawable
 /* }}} */
 
 /* Font {{{ */
@@ -150,12 +152,18 @@ void subSharedFontKill(Display *disp, SubFont *f); ///< Kill font
 /* }}} */
 
 /* Misc {{{ */
+int subSharedColorAlloc(Display *disp, XColor *xcolor); ///< Allocate color
+void subSharedColorQuery(Display *disp, XColor *xcolor); ///< Query color
+unsigned long subSharedHash(unsigned long hash, const void *data,
+                            size_t len); ///< Hash data
 unsigned long subSharedParseColor(Display *disp, char *name); ///< Parse color
 KeySym subSharedParseKey(Display *disp, const char *key, unsigned int *code, unsigned int *state,
                          int *mouse); ///< Parse keys
 pid_t subSharedSpawn(char *cmd); ///< Spawn command
 int subSharedStringWidth(Display *disp, SubFont *f, const char *text, int len, int *left,
                          int *right, int center); ///< Get text width
+void subSharedStringWidthStats(unsigned long *nhits,
+                               unsigned long *nmisses); ///< Get width cache stats
 /* }}} */
 
 #ifndef SUBTLE
@@ -12,6 +12,51 @@
 
 #include "subtle.h"
 
+/* IndexInsert {{{ */
+static void IndexInsert(SubIndex *idx, unsigned long key, int id) {
+    int i, slot;
+
+    /* Linear probing */
+    for (i = 0; i < idx->size; i++) {
+        slot = (key + i) & (idx->size - 1);
+
+        if (0 == idx->ids[slot]) {
+            idx->ids[slot] = id + 1;
+            idx->keys[slot] = key;
+
+            break;
+        }
+    }
+} /* }}} */
+
+/* IndexSync {{{ */
+static void IndexSync(SubIndex *idx) {
+    int i;
+
+    /* Rebuild when ids moved or table is too small */
+    if (idx->version != idx->array->version || idx->size < 2 * idx->array->ndata) {
+        while (idx->size < 2 * idx->array->ndata) {
+            idx->size = idx->size ? idx->size << 1 : 16;
+        }
+
+        idx->ids = (int *) subSharedMemoryRealloc(idx->ids, idx->size * sizeof(int));
+        idx->keys = (unsigned long *) subSharedMemoryRealloc(idx->keys,
+                                                             idx->size * sizeof(unsigned long));
+
+        memset(idx->ids, 0, idx->size * sizeof(int));
+        idx->version = idx->array->version;
+        idx->nentries = 0;
+    }
+
+    /* Add pushed elements */
+    for (i = idx->nentries; i < idx->array->ndata; i++) {
+        IndexInsert(idx, idx->key(idx->array->data[i]), i);
+    }
+
+    idx->nentries = idx->array->ndata;
+} /* }}} */
+
+
 /** subArrayNew {{{
  * @brief Create new array and init it
  * @return Returns a #SubArray or \p NULL
@@ -58,6 +103,7 @@ void subArrayInsert(SubArray *a, int pos, void *elem) {
         }
 
         a->data[pos] = elem;
+        a->version++;
     } else subArrayPush(a, elem);
 } /* }}} */
 
@@ -79,6 +125,7 @@ void subArrayRemove(SubArray *a, void *elem) {
 
         a->ndata--;
         a->data = (void **) subSharedMemoryRealloc(a->data, a->ndata * sizeof(void *));
+        a->version++;
     }
 } /* }}} */
 
@@ -127,6 +174,7 @@ void subArraySort(SubArray *a, int (*compar)(const void *a, const void *b)) {
 
     if (0 < a->ndata) {
         qsort(a->data, a->ndata, sizeof(void *), compar);
+        a->version++;
     }
 } /* }}} */
 
@@ -174,6 +222,7 @@ void subArrayClear(SubArray *a, int clean) {
 
         a->data = NULL;
         a->ndata = 0;
+        a->version++;
     }
 } /* }}} */
 
@@ -192,4 +241,71 @@ void subArrayKill(SubArray *a, int clean) {
     }
 } /* }}} */
 
+/** subIndexNew {{{
+ * @brief Create new index of array elements
+ * @param[in]  a    A #SubArray
+ * @param[in]  key  Key function of elements
+ * @return Returns a #SubIndex or \p NULL
+ **/
+
+SubIndex *subIndexNew(SubArray *a, unsigned long (*key)(void *elem)) {
+    SubIndex *idx = NULL;
+
+    assert(a && key);
+
+    idx = (SubIndex *) subSharedMemoryAlloc(1, sizeof(SubIndex));
+    idx->array = a;
+    idx->key = key;
+    idx->version = a->version - 1; ///< Build on first use
+
+    return idx;
+} /* }}} */
+
+/** subIndexFind {{{
+ * @brief Find next element id with key
+ * @param[in]     idx  A #SubIndex
+ * @param[in]     key  Key to find
+ * @param[inout]  pos  Probe position, start with \p 0
+ * @return Returns found id or \p -1
+ **/
+
+int subIndexFind(SubIndex *idx, unsigned long key, int *pos) {
+    int slot;
+
+    assert(idx && pos);
+
+    IndexSync(idx);
+
+    /* Keys may collide, so callers check the element */
+    for (; *pos < idx->size; (*pos)++) {
+        slot = (key + *pos) & (idx->size - 1);
+
+        if (0 == idx->ids[slot]) {
+            break;
+        } else if (idx->keys[slot] == key) {
+            (*pos)++;
+
+            return idx->ids[slot] - 1;
+        }
+    }
+
+    return -1;
+} /* }}} */
+
+/** subIndexKill {{{
+ * @brief Kill index
+ * @param[in]  idx  A #SubIndex
+ **/
+
+void subIndexKill(SubIndex *idx) {
+    if (idx) {
+        if (idx->ids) {
+            free(idx->ids);
+            free(idx->keys);
+        }
+
+        free(idx);
+    }
+} /* }}} */
+
 // vim:ts=2:bs=2:sw=2:et:fdm=marker
@@ -156,25 +156,72 @@ static void ClientResize(SubClient *c, XRectangle *bounds) {
 
     subClientResize(c, bounds, True);
     XMoveResizeWindow(subtle->dpy, c->win, c->geom.x, c->geom.y, c->geom.width, c->geom.height);
+
+    subClientSpatialUpdate(c);
+} /* }}} */
+
+/* ClientHotAdd {{{ */
+static void ClientHotAdd(SubClient *c) {
+    /* Grow arrays on demand */
+    if (subtle->hot.size == subtle->hot.nentries) {
+        subtle->hot.size = MAX(8, 2 * subtle->hot.size);
+
+        subtle->hot.clients = (SubClient **) subSharedMemoryRealloc(
+                subtle->hot.clients, subtle->hot.size * sizeof(SubClient *));
+        subtle->hot.flags = (FLAGS *) subSharedMemoryRealloc(subtle->hot.flags,
+                                                             subtle->hot.size * sizeof(FLAGS));
+        subtle->hot.tags = (TAGS *) subSharedMemoryRealloc(subtle->hot.tags,
+                                                           subtle->hot.size * sizeof(TAGS));
+        subtle->hot.screenids = (int *) subSharedMemoryRealloc(subtle->hot.screenids,
+                                                               subtle->hot.size * sizeof(int));
+        subtle->hot.gravityids = (int *) subSharedMemoryRealloc(subtle->hot.gravityids,
+                                                                subtle->hot.size * sizeof(int));
+    }
+
+    c->slot = subtle->hot.nentries++;
+    subtle->hot.clients[c->slot] = c;
+
+    subClientHotStore(c);
+} /* }}} */
+
+/* ClientHotRemove {{{ */
+static void ClientHotRemove(SubClient *c) {
+    int i, n = 0;
+
+    if (-1 == c->slot) return;
+
+    /* Shift following slots to keep mapping order for tiling */
+    n = --subtle->hot.nentries - c->slot;
+
+    memmove(subtle->hot.clients + c->slot, subtle->hot.clients + c->slot + 1,
+            n * sizeof(SubClient *));
+    memmove(subtle->hot.flags + c->slot, subtle->hot.flags + c->slot + 1, n * sizeof(FLAGS));
+    memmove(subtle->hot.tags + c->slot, subtle->hot.tags + c->slot + 1, n * sizeof(TAGS));
+    memmove(subtle->hot.screenids + c->slot, subtle->hot.screenids + c->slot + 1,
+            n * sizeof(int));
+    memmove(subtle->hot.gravityids + c->slot, subtle->hot.gravityids + c->slot + 1,
+            n * sizeof(int));
+
+    for (i = c->slot; i < subtle->hot.nentries; i++) {
+        subtle->hot.clients[i]->slot = i;
+    }
+
+    c->slot = -1;
 } /* }}} */
 
 /* ClientTile {{{ */
 static void ClientTile(int gravity, int screen) {
     int i, used = 0, pos = 0, calc = 0, fix = 0;
+    TAGS *visible = &subtle->visible_tags;
+    FLAGS *flags = subtle->hot.flags;
+    TAGS *tags = subtle->hot.tags;
+    int *gravityids = subtle->hot.gravityids, *screenids = subtle->hot.screenids;
     XRectangle geom = {1};
     SubScreen *s = SCREEN(subArrayGet(subtle->screens, screen));
     SubGravity *g = GRAVITY(subArrayGet(subtle->gravities, gravity));
 
     /* Pass 1: Count clients with this gravity */
-    for (i = 0; i < subtle->clients->ndata; i++) {
-        SubClient *c = CLIENT(subtle->clients->data[i]);
-
-        if (c->gravityid == gravity && c->screenid == screen && subtle->visible_tags & c->tags
-            && !(c->flags & (SUB_CLIENT_MODE_FLOAT | SUB_CLIENT_MODE_FULL)))
-        {
-            used++;
-        }
-    }
+    used = subClientHotCount(gravity, screen);
 
     if (0 == used || !s || !g)
         return;
@@ -191,12 +238,12 @@ static void ClientTile(int gravity, int screen) {
     }
 
     /* Pass 2: Update geometry of every client with this gravity */
-    for (i = 0; i < subtle->clients->ndata; i++) {
-        SubClient *c = CLIENT(subtle->clients->data[i]);
-
-        if (c->gravityid == gravity && c->screenid == screen && subtle->visible_tags & c->tags
-            && !(c->flags & (SUB_CLIENT_MODE_FLOAT | SUB_CLIENT_MODE_FULL)))
+    for (i = 0; i < subtle->hot.nentries; i++) {
+        if (gravityids[i] == gravity && screenids[i] == screen && subTagsMatch(visible, &tags[i])
+            && !(flags[i] & (SUB_CLIENT_MODE_FLOAT | SUB_CLIENT_MODE_FULL)))
         {
+            SubClient *c = subtle->hot.clients[i];
+
             if (g->flags & SUB_GRAVITY_HORZ) {
                 c->geom.width = pos == used ? calc + fix : calc;
                 c->geom.height = geom.height;
@@ -245,54 +292,427 @@ static void ClientZaphod(SubClient *c, XRectangle *bounds) {
     }
 } /* }}} */
 
-/* ClientCompare {{{ */
-static int ClientCompare(const void *a, const void *b) {
-    int ret = 0, dirret = 0;
-    SubClient *c1 = *(SubClient **) a, *c2 = *(SubClient **) b;
-
-    assert(a && b);
-
-    /* Direction is required when we change stacking on a level */
-    if (SUB_CLIENT_RESTACK_DOWN == c1->dir) {
-        dirret = -1;
-    } else if (SUB_CLIENT_RESTACK_UP == c1->dir) {
-        dirret = 1;
-    } else if (SUB_CLIENT_RESTACK_DOWN == c2->dir) {
-        dirret = 1;
-    } else if (SUB_CLIENT_RESTACK_UP == c2->dir) {
-        dirret = -1;
-    }
-
-    /* Complicated comparisons to ensure stacking order. Our desired
-     * order is following: desktop < gravity < float < full
-     *
-     * This function returns following values:
-     * -1 => c1 is on a lower level
-     *  0 => c1 and c2 are on the same level
-     *  1 => c1 is on a higher level */
-    if (c1->flags & SUB_CLIENT_TYPE_DESKTOP) {
-        if (c2->flags & SUB_CLIENT_TYPE_DESKTOP) {
-            ret = dirret;
-        } else ret = 0;
-    } else if (c1->flags & SUB_CLIENT_MODE_FULL) {
-        if (c2->flags & SUB_CLIENT_MODE_FULL) {
-            ret = dirret;
-        } else ret = 1;
-    } else if (c1->flags & SUB_CLIENT_MODE_FLOAT) {
-        if (c2->flags & SUB_CLIENT_MODE_FULL) {
-            ret = -1;
-        } else if (c2->flags & SUB_CLIENT_MODE_FLOAT) {
-            ret = dirret;
-        } else ret = 1;
+/* ClientLayer {{{ */
+static int ClientLayer(SubClient *c) {
+    /* Our stacking order is following: desktop < gravity < float < full */
+    if (c->flags & SUB_CLIENT_TYPE_DESKTOP) {
+        return SUB_CLIENT_LAYER_DESKTOP;
+    } else if (c->flags & SUB_CLIENT_MODE_FULL) {
+        return SUB_CLIENT_LAYER_FULL;
+    } else if (c->flags & SUB_CLIENT_MODE_FLOAT) {
+        return SUB_CLIENT_LAYER_FLOAT;
+    }
+
+    return SUB_CLIENT_LAYER_GRAVITY;
+} /* }}} */
+
+/* ClientLink {{{ */
+static void ClientLink(SubClient *c, int dir) {
+    c->layer = ClientLayer(c);
+
+    /* Add client either on top or at the bottom of its layer */
+    if (SUB_CLIENT_RESTACK_UP == dir) {
+        c->below = subtle->layers[c->layer].top;
+        c->above = NULL;
+
+        if (c->below) {
+            c->below->above = c;
+        } else subtle->layers[c->layer].bottom = c;
+
+        subtle->layers[c->layer].top = c;
+        c->stack = ++subtle->layers[c->layer].upper;
+    } else {
+        c->below = NULL;
+        c->above = subtle->layers[c->layer].bottom;
+
+        if (c->above) {
+            c->above->below = c;
+        } else subtle->layers[c->layer].top = c;
+
+        subtle->layers[c->layer].bottom = c;
+        c->stack = --subtle->layers[c->layer].lower;
+    }
+} /* }}} */
+
+/* ClientUnlink {{{ */
+static void ClientUnlink(SubClient *c) {
+    if (-1 == c->layer) return;
+
+    if (c->below) {
+        c->below->above = c->above;
+    } else subtle->layers[c->layer].bottom = c->above;
+
+    if (c->above) {
+        c->above->below = c->below;
+    } else subtle->layers[c->layer].top = c->below;
+
+    c->below = c->above = NULL;
+    c->layer = -1;
+} /* }}} */
+
+/* ClientHistory {{{ */
+static SubHistory *ClientHistory(int screenid) {
+    int n = MAX(0, screenid) + 1;
+
+    /* Grow screen heads on demand */
+    if (subtle->history.nscreens < n) {
+        subtle->history.screens = (SubHistory *) subSharedMemoryRealloc(subtle->history.screens,
+                                                                        n * sizeof(SubHistory));
+
+        memset(subtle->history.screens + subtle->history.nscreens, 0,
+               (n - subtle->history.nscreens) * sizeof(SubHistory));
+        subtle->history.nscreens = n;
+    }
+
+    return &subtle->history.screens[n - 1];
+} /* }}} */
+
+/* ClientScreenForget {{{ */
+static void ClientScreenForget(SubClient *c) {
+    SubHistory *h = NULL;
+
+    if (-1 == c->historyid) return;
+
+    h = &subtle->history.screens[c->historyid];
+
+    if (c->snewer) {
+        c->snewer->solder = c->solder;
+    } else if (h->newest == c) {
+        h->newest = c->solder;
+    }
+
+    if (c->solder) {
+        c->solder->snewer = c->snewer;
+    } else if (h->oldest == c) {
+        h->oldest = c->snewer;
+    }
+
+    c->snewer = c->solder = NULL;
+    c->historyid = -1;
+} /* }}} */
+
+/* ClientScreenRemember {{{ */
+static void ClientScreenRemember(SubClient *c, int recent) {
+    SubHistory *h = ClientHistory(c->screenid);
+
+    ClientScreenForget(c);
+
+    /* Same as the global history, just for the screen of the client */
+    if (recent) {
+        c->solder = h->newest;
+
+        if (c->solder) {
+            c->solder->snewer = c;
+        } else h->oldest = c;
+
+        h->newest = c;
+    } else {
+        c->snewer = h->oldest;
+
+        if (c->snewer) {
+            c->snewer->solder = c;
+        } else h->newest = c;
+
+        h->oldest = c;
+    }
+
+    c->historyid = MAX(0, c->screenid);
+} /* }}} */
+
+/* ClientForget {{{ */
+static void ClientForget(SubClient *c) {
+    if (c->newer) {
+        c->newer->older = c->older;
+    } else if (subtle->history.newest == c) {
+        subtle->history.newest = c->older;
+    }
+
+    if (c->older) {
+        c->older->newer = c->newer;
+    } else if (subtle->history.oldest == c) {
+        subtle->history.oldest = c->newer;
+    }
+
+    c->newer = c->older = NULL;
+
+    ClientScreenForget(c);
+} /* }}} */
+
+/* ClientRemember {{{ */
+static void ClientRemember(SubClient *c, int recent) {
+    ClientForget(c);
+
+    /* Either move client to the front or add it as least recent one */
+    if (recent) {
+        c->older = subtle->history.newest;
+
+        if (c->older) {
+            c->older->newer = c;
+        } else subtle->history.oldest = c;
+
+        subtle->history.newest = c;
+    } else {
+        c->newer = subtle->history.oldest;
+
+        if (c->newer) {
+            c->newer->older = c;
+        } else subtle->history.newest = c;
+
+        subtle->history.oldest = c;
+    }
+
+    ClientScreenRemember(c, recent);
+} /* }}} */
+
+/* ClientMigrate {{{ */
+static void ClientMigrate(SubClient *c) {
+    /* Move client to the history of its new screen */
+    if (-1 != c->historyid && c->historyid != MAX(0, c->screenid)) {
+        ClientScreenRemember(c, subtle->windows.focus[0] == c->win);
+    }
+} /* }}} */
+
+/* ClientSibling {{{ */
+static SubClient *ClientSibling(SubClient *c, int dir) {
+    int i;
+
+    /* Find nearest client below or above across layers */
+    if (SUB_CLIENT_RESTACK_DOWN == dir) {
+        if (c->below) return c->below;
+
+        for (i = c->layer - 1; 0 <= i; i--) {
+            if (subtle->layers[i].top) return subtle->layers[i].top;
+        }
+    } else {
+        if (c->above) return c->above;
+
+        for (i = c->layer + 1; i < SUB_CLIENT_LAYERS; i++) {
+            if (subtle->layers[i].bottom) return subtle->layers[i].bottom;
+        }
+    }
+
+    return NULL;
+} /* }}} */
+
+/* ClientMatch {{{ */
+static int ClientMatch(int type, XRectangle *origin, XRectangle *test) {
+    int cx_origin = 0, cx_test = 0, cy_origin = 0, cy_test = 0, dx = 0, dy = 0;
+
+    /* This check is complicated and consists of three parts:
+     * 1) Calculate window center positions
+     * 2) Check if x/y values decrease in given direction
+     * 3) Check if a corner of one of the rects is close enough to
+     *    a side of the other rect */
+
+    /* Calculate window centers */
+    cx_origin = origin->x + (origin->width / 2);
+    cx_test = test->x + (test->width / 2);
+
+    cy_origin = origin->y + (origin->height / 2);
+    cy_test = test->y + (test->height / 2);
+
+    /* Check geometries */
+    if ((((SUB_GRAB_DIRECTION_LEFT == type && cx_test <= cx_origin)
+        || (SUB_GRAB_DIRECTION_RIGHT == type && cx_test >= cx_origin))
+         && ((cy_test >= origin->y && cy_test <= origin->y + origin->height)
+        || (cy_origin >= test->y && cy_origin <= test->y + test->height)))
+
+        || (((SUB_GRAB_DIRECTION_UP == type && cy_test <= cy_origin)
+        || (SUB_GRAB_DIRECTION_DOWN == type && cy_test >= cy_origin))
+        && ((cx_test >= origin->x && cx_test <= origin->x + origin->width)
+        || (cx_origin >= test->x && cx_origin <= test->x + test->width))))
+    {
+        /* Euclidean distance */
+        dx = abs(cx_origin - cx_test);
+        dy = abs(cy_origin - cy_test);
+
+        /* Zero distance means same dimensions - highest distance */
+        if (0 == dx && 0 == dy)
+            dx = dy = 1L << 15;
     } else {
-        if (c2->flags & SUB_CLIENT_TYPE_DESKTOP) {
-            ret = 1;
-        } else if (c2->flags & (SUB_CLIENT_MODE_FLOAT | SUB_CLIENT_MODE_FULL)) {
-            ret = -1;
-        } else ret = dirret;
+        /* No match - highest distance too */
+        dx = 1L << 15;
+        dy = 1L << 15;
+    }
+
+    return dx + dy;
+} /* }}} */
+
+/* ClientSpatialCompareX {{{ */
+static int ClientSpatialCompareX(const void *a, const void *b) {
+    SubSpatial *s1 = (SubSpatial *) a, *s2 = (SubSpatial *) b;
+
+    return s1->cx < s2->cx ? -1 : (s1->cx == s2->cx ? 0 : 1);
+} /* }}} */
+
+/* ClientSpatialCompareY {{{ */
+static int ClientSpatialCompareY(const void *a, const void *b) {
+    SubSpatial *s1 = (SubSpatial *) a, *s2 = (SubSpatial *) b;
+
+    return s1->cy < s2->cy ? -1 : (s1->cy == s2->cy ? 0 : 1);
+} /* }}} */
+
+/* ClientSpatialBuild {{{ */
+static void ClientSpatialBuild(void) {
+    int i;
+    SubScreen *s = NULL;
+
+    if (!subtle->spatial.stale) return;
+
+    /* Count visible clients per screen */
+    for (i = 0; i < subtle->screens->ndata; i++) {
+        SCREEN(subtle->screens->data[i])->nspatial = 0;
+    }
+
+    for (i = 0; i < subtle->hot.nentries; i++) {
+        if ((subTagsMatch(&subtle->visible_tags, &subtle->hot.tags[i])
+             || subtle->hot.flags[i] & SUB_CLIENT_MODE_STICK)
+            && (s = SCREEN(subArrayGet(subtle->screens, subtle->hot.screenids[i]))))
+        {
+            s->nspatial++;
+        }
+    }
+
+    /* Grow indices */
+    for (i = 0; i < subtle->screens->ndata; i++) {
+        s = SCREEN(subtle->screens->data[i]);
+
+        if (s->nslots < s->nspatial) {
+            s->nslots = MAX(s->nspatial, 2 * s->nslots);
+
+            s->byx = (SubSpatial *) subSharedMemoryRealloc(s->byx, s->nslots * sizeof(SubSpatial));
+            s->byy = (SubSpatial *) subSharedMemoryRealloc(s->byy, s->nslots * sizeof(SubSpatial));
+        }
+
+        s->nspatial = 0;
+    }
+
+    /* Collect centres of visible clients */
+    for (i = 0; i < subtle->hot.nentries; i++) {
+        if ((subTagsMatch(&subtle->visible_tags, &subtle->hot.tags[i])
+             || subtle->hot.flags[i] & SUB_CLIENT_MODE_STICK)
+            && (s = SCREEN(subArrayGet(subtle->screens, subtle->hot.screenids[i]))))
+        {
+            SubClient *c = subtle->hot.clients[i];
+            SubSpatial *e = &s->byx[s->nspatial++];
+
+            e->c = c;
+            e->geom = c->geom;
+            e->cx = c->geom.x + (c->geom.width / 2);
+            e->cy = c->geom.y + (c->geom.height / 2);
+        }
+    }
+
+    /* Sort along both axes */
+    for (i = 0; i < subtle->screens->ndata; i++) {
+        s = SCREEN(subtle->screens->data[i]);
+
+        memcpy(s->byy, s->byx, s->nspatial * sizeof(SubSpatial));
+
+        qsort(s->byx, s->nspatial, sizeof(SubSpatial), ClientSpatialCompareX);
+        qsort(s->byy, s->nspatial, sizeof(SubSpatial), ClientSpatialCompareY);
+    }
+
+    subtle->spatial.stale = False;
+} /* }}} */
+
+/* ClientSpatialSift {{{ */
+static int ClientSpatialSift(SubSpatial *index, int n, SubClient *c, int horz) {
+    int i, pos = 0;
+    SubSpatial e;
+
+    /* Find entry of client */
+    for (i = 0; i < n && index[i].c != c; i++);
+
+    if (i == n) return False;
+
+    e = index[i];
+    e.geom = c->geom;
+    e.cx = c->geom.x + (c->geom.width / 2);
+    e.cy = c->geom.y + (c->geom.height / 2);
+    pos = horz ? e.cx : e.cy;
+
+    /* Shift neighbours until entry is sorted again */
+    for (; 0 < i && (horz ? index[i - 1].cx : index[i - 1].cy) > pos; i--) {
+        index[i] = index[i - 1];
+    }
+    for (; i < n - 1 && (horz ? index[i + 1].cx : index[i + 1].cy) < pos; i++) {
+        index[i] = index[i + 1];
+    }
+
+    index[i] = e;
+
+    return True;
+} /* }}} */
+
+/* ClientSpatialBound {{{ */
+static int ClientSpatialBound(SubSpatial *index, int n, int horz, int value, int upper) {
+    int lo = 0, hi = n;
+
+    /* Find first entry at (lower) or after (upper) value */
+    while (lo < hi) {
+        int mid = (lo + hi) / 2, pos = horz ? index[mid].cx : index[mid].cy;
+
+        if (pos < value || (upper && pos == value)) {
+            lo = mid + 1;
+        } else hi = mid;
+    }
+
+    return lo;
+} /* }}} */
+
+/* ClientSpatialPrefer {{{ */
+static int ClientSpatialPrefer(SubSpatial *a, SubSpatial *b) {
+    int j, rank_a = HISTORYSIZE, rank_b = HISTORYSIZE;
+
+    if (!b) return True;
+
+    /* Prefer recently focussed and then upper clients */
+    for (j = 1; j < HISTORYSIZE; j++) {
+        if (subtle->windows.focus[j] == a->c->win) rank_a = j;
+        if (subtle->windows.focus[j] == b->c->win) rank_b = j;
     }
 
-    return ret;
+    return rank_a < rank_b || (rank_a == rank_b && (a->c->layer > b->c->layer
+                                                     || (a->c->layer == b->c->layer
+                                                         && a->c->stack > b->c->stack)));
+} /* }}} */
+
+/* ClientSpatialWalk {{{ */
+static SubSpatial *ClientSpatialWalk(SubScreen *s, SubClient *c, int direction, int *match,
+                                     SubSpatial *found)
+{
+    int i, step = 1, origin = 0, distance = 0, horz = False;
+    SubSpatial *index = NULL;
+
+    /* Select axis and walking direction */
+    horz = (SUB_GRAB_DIRECTION_LEFT == direction || SUB_GRAB_DIRECTION_RIGHT == direction);
+    index = horz ? s->byx : s->byy;
+    origin = horz ? c->geom.x + (c->geom.width / 2) : c->geom.y + (c->geom.height / 2);
+
+    if (SUB_GRAB_DIRECTION_LEFT == direction || SUB_GRAB_DIRECTION_UP == direction) {
+        i = ClientSpatialBound(index, s->nspatial, horz, origin, True) - 1;
+        step = -1;
+    } else i = ClientSpatialBound(index, s->nspatial, horz, origin, False);
+
+    /* Walk away from origin until no closer client is possible */
+    for (; 0 <= i && i < s->nspatial; i += step) {
+        SubSpatial *e = &index[i];
+
+        if (abs((horz ? e->cx : e->cy) - origin) > *match) break;
+        if (e->c == c) continue;
+
+        distance = ClientMatch(direction, &c->geom, &e->geom);
+
+        if (distance < *match || (distance == *match && distance < (1L << 16)
+                                  && ClientSpatialPrefer(e, found)))
+        {
+            *match = distance;
+            found = e;
+        }
+    }
+
+    return found;
 } /* }}} */
 
 /* Public */
@@ -324,7 +744,9 @@ SubClient *subClientNew(Window win) {
     c->gravities = (int *) subSharedMemoryAlloc(subtle->views->ndata, sizeof(int));
     c->flags = (SUB_TYPE_CLIENT | SUB_CLIENT_INPUT);
     c->gravityid = -1; ///< Force update
-    c->dir = -1;
+    c->layer = -1;
+    c->slot = -1;
+    c->historyid = -1;
     c->win = win;
 
     /* Window attributes */
@@ -368,6 +790,30 @@ SubClient *subClientNew(Window win) {
     subClientToggle(c, flags, False);
     subGrabUnset(c->win);
 
+    /* Add to stacking layer unless toggle already did, scan goes top to bottom */
+    if (-1 == c->layer) {
+        ClientLink(c, subtle->flags & SUB_SUBTLE_SCAN ? SUB_CLIENT_RESTACK_DOWN
+                                                       : SUB_CLIENT_RESTACK_UP);
+    }
+
+    /* Add to focus history as least recent one */
+    ClientRemember(c, False);
+
+    /* Add to hot state */
+    ClientHotAdd(c);
+
+    /* EWMH: Append to client list unless it is rewritten anyway */
+    subtle->list.wins = (Window *) subSharedMemoryRealloc(
+            subtle->list.wins, (subtle->list.nwins + 1) * sizeof(Window));
+    subtle->list.wins[subtle->list.nwins++] = c->win;
+
+    if (!(subtle->list.flags & SUB_CLIENT_LIST_REPLACE)) {
+        subEwmhAppendWindows(ROOT, SUB_EWMH_NET_CLIENT_LIST, &c->win, 1);
+    }
+
+    subtle->list.flags |= SUB_CLIENT_LIST_STACKING;
+    subtle->spatial.stale = True;
+
     /* Set leader window */
     if ((leader = (Window *) subSharedPropertyGet(subtle->dpy, c->win, XA_WINDOW,
                                                   subEwmhGet(SUB_EWMH_WM_CLIENT_LEADER), NULL)))
@@ -455,9 +901,10 @@ void subClientDimension(int id) {
  **/
 
 void subClientFocus(SubClient *c, int warp) {
+    int i;
     SubScreen *s = NULL;
     SubView *v = NULL;
-    SubClient *focus = NULL;
+    SubClient *focus = NULL, *iter = NULL;
 
     DEAD(c);
     assert(c);
@@ -469,21 +916,13 @@ void subClientFocus(SubClient *c, int warp) {
     /* Remove urgent after getting focus */
     if (c->flags & SUB_CLIENT_MODE_URGENT) {
         c->flags &= ~SUB_CLIENT_MODE_URGENT;
-        subtle->urgent_tags &= ~c->tags;
+        subTagsRemove(&subtle->urgent_tags, &c->tags);
     }
 
     /* Unset current focus */
     if ((focus = CLIENT(subSubtleFind(subtle->windows.focus[0], CLIENTID)))) {
-        int i;
-
         subGrabUnset(focus->win);
 
-        /* Reorder focus history */
-        for (i = (HISTORYSIZE - 1); 0 < i; i--) {
-            subtle->windows.focus[i] = subtle->windows.focus[i - 1];
-        }
-        subtle->windows.focus[0] = 0;
-
         /* Exclude desktop type windows */
         if (!(focus->flags & SUB_CLIENT_TYPE_DESKTOP)) {
             XSetWindowBorder(subtle->dpy, focus->win, subtle->styles.clients.bg);
@@ -498,8 +937,14 @@ void subClientFocus(SubClient *c, int warp) {
         XSetInputFocus(subtle->dpy, c->win, RevertToPointerRoot, CurrentTime);
     }
 
-    /* Update focus */
-    subtle->windows.focus[0] = c->win;
+    /* Update focus history and copy the most recent ones */
+    ClientRemember(c, True);
+
+    for (i = 0, iter = c; i < HISTORYSIZE; i++) {
+        subtle->windows.focus[i] = iter ? iter->win : None;
+        iter = iter ? iter->older : NULL;
+    }
+
     subGrabSet(c->win, SUB_GRAB_MOUSE);
 
     /* Exclude desktop and dock type windows */
@@ -541,46 +986,98 @@ void subClientFocus(SubClient *c, int warp) {
  **/
 
 SubClient *subClientNext(int screenid, int jump) {
-    int i;
     SubClient *c = NULL;
 
     /* Pass 1: Check focus history of current screen */
-    for (i = 1; i < HISTORYSIZE; i++) {
-        if ((c = CLIENT(subSubtleFind(subtle->windows.focus[i], CLIENTID)))) {
-            /* Check visibility on current screen */
-            if (c->screenid == screenid && ALIVE(c) && VISIBLE(c) &&
-                c->win != subtle->windows.focus[0])
+    if (0 <= screenid && screenid < subtle->history.nscreens) {
+        for (c = subtle->history.screens[screenid].newest; c; c = c->solder) {
+            if (c->screenid == screenid && ALIVE(c) && VISIBLE(c)
+                && c->win != subtle->windows.focus[0])
             {
                 return c;
             }
         }
     }
 
-    /* Pass 2: Check client stacking list backwards of current screen */
-    for (i = subtle->clients->ndata - 1; 0 <= i; i--) {
-        c = CLIENT(subtle->clients->data[i]);
+    /* Pass 2: Check focus history of any visible screen */
+    if (1 < subtle->screens->ndata && jump) {
+        for (c = subtle->history.newest; c; c = c->older) {
+            if (ALIVE(c) && VISIBLE(c) && c->win != subtle->windows.focus[0]) {
+                return c;
+            }
+        }
+    }
+
+    return NULL;
+} /* }}} */
 
-        /* Check visibility on current screen */
-        if (c->screenid == screenid && ALIVE(c) && VISIBLE(c)
-            && c->win != subtle->windows.focus[0])
-        {
-            return c;
+/** subClientSelect {{{
+ * @brief Find nearest visible client in given direction
+ * @param[in]  c          A #SubClient
+ * @param[in]  direction  Grab direction
+ * @return Returns a #SubClient or \p NULL
+ **/
+
+SubClient *subClientSelect(SubClient *c, int direction) {
+    int i, j, match = (1L << 16);
+    SubScreen *s = NULL;
+    SubSpatial *found = NULL;
+
+    assert(c);
+
+    ClientSpatialBuild();
+
+    /* Start on the screen of the client, the bound keeps the others short */
+    if ((s = SCREEN(subArrayGet(subtle->screens, c->screenid)))) {
+        found = ClientSpatialWalk(s, c, direction, &match, found);
+    }
+
+    for (i = 0; i < subtle->screens->ndata; i++) {
+        if (i != c->screenid) {
+            found = ClientSpatialWalk(SCREEN(subtle->screens->data[i]), c, direction, &match,
+                                      found);
         }
     }
 
-    /* Pass 3: Check client stacking list backwards of any visible screen */
-    if (1 < subtle->screens->ndata && jump) {
-        for (i = subtle->clients->ndata - 1; 0 <= i; i--) {
-            c = CLIENT(subtle->clients->data[i]);
+    /* Nothing in that direction: take the preferred one of all */
+    if (!found) {
+        for (i = 0; i < subtle->screens->ndata; i++) {
+            s = SCREEN(subtle->screens->data[i]);
 
-            /* Check visibility on current screen */
-            if (ALIVE(c) && VISIBLE(c) && c->win != subtle->windows.focus[0]) {
-                return c;
+            for (j = 0; j < s->nspatial; j++) {
+                if (s->byx[j].c != c && ClientSpatialPrefer(&s->byx[j], found)) {
+                    found = &s->byx[j];
+                }
             }
         }
     }
 
-    return NULL;
+    return found ? found->c : NULL;
+} /* }}} */
+
+/** subClientSpatialUpdate {{{
+ * @brief Update entry of moved client in the spatial index in place
+ * @param[in]  c  A #SubClient
+ **/
+
+void subClientSpatialUpdate(SubClient *c) {
+    SubScreen *s = NULL;
+
+    assert(c);
+
+    /* Rebuilt on next use anyway */
+    if (subtle->spatial.stale) return;
+
+    /* Not indexed on its screen: membership changed */
+    if (!(s = SCREEN(subArrayGet(subtle->screens, c->screenid)))
+        || !ClientSpatialSift(s->byx, s->nspatial, c, True))
+    {
+        subtle->spatial.stale = True;
+
+        return;
+    }
+
+    ClientSpatialSift(s->byy, s->nspatial, c, False);
 } /* }}} */
 
 /** subClientWarp {{{
@@ -774,6 +1271,8 @@ void subClientDrag(SubClient *c, int mode, int direction) {
 
     XMoveResizeWindow(subtle->dpy, c->win, c->geom.x, c->geom.y, c->geom.width, c->geom.height);
 
+    subClientSpatialUpdate(c);
+
     /* Remove grabs */
     XUngrabPointer(subtle->dpy, CurrentTime);
     XUngrabServer(subtle->dpy);
@@ -799,7 +1298,7 @@ void subClientTag(SubClient *c, int tag, int *flags) {
 
         /* Collect flags and tags */
         *flags |= (t->flags & (TYPES_ALL | MODES_ALL));
-        c->tags |= (1L << (tag + 1));
+        subTagsSet(&c->tags, tag);
 
         /* Set size/position and enable float */
         if (t->flags & (SUB_TAG_GEOMETRY | SUB_TAG_POSITION)) {
@@ -818,6 +1317,8 @@ void subClientTag(SubClient *c, int tag, int *flags) {
         if (t->flags & SUB_CLIENT_MODE_STICK && -1 != t->screenid) {
             c->flags |= SUB_CLIENT_MODE_STICK_SCREEN;
             c->screenid = t->screenid;
+
+            ClientMigrate(c);
         }
 
         /* Set gravity matching views */
@@ -825,7 +1326,7 @@ void subClientTag(SubClient *c, int tag, int *flags) {
             SubView *v = VIEW(subtle->views->data[i]);
 
             /* Match views with this tag or sticky only */
-            if (v->tags & (1L << (tag + 1)) || t->flags & SUB_CLIENT_MODE_STICK)
+            if (subTagsCheck(&v->tags, tag) || t->flags & SUB_CLIENT_MODE_STICK)
                 if (t->flags & SUB_TAG_GRAVITY) {
                     c->gravities[i] = t->gravityid;
                 }
@@ -836,6 +1337,8 @@ void subClientTag(SubClient *c, int tag, int *flags) {
             subRubyCall(SUB_CALL_HOOKS, t->proc, (void *) c);
         }
     }
+
+    subClientHotStore(c);
 } /* }}} */
 
 /** subClientRetag {{{
@@ -850,9 +1353,11 @@ void subClientRetag(SubClient *c, int *flags) {
     DEAD(c);
     assert(c);
 
-    c->tags = 0; ///< Reset tags
+    memset(&c->tags, 0, sizeof(TAGS)); ///< Reset tags
 
     /* Check matching tags */
+    subTagMatcherScan(c);
+
     for (i = 0; i < subtle->tags->ndata; i++) {
         /* Check if tag matches client */
         if (subTagMatcherCheck(TAG(subtle->tags->data[i]), c)) {
@@ -865,7 +1370,7 @@ void subClientRetag(SubClient *c, int *flags) {
         int visible = 0;
 
         for (i = 0; i < subtle->views->ndata; i++) {
-            if (VIEW(subtle->views->data[i])->tags & c->tags) {
+            if (subTagsMatch(&VIEW(subtle->views->data[i])->tags, &c->tags)) {
                 visible++;
                 break;
             }
@@ -876,8 +1381,10 @@ void subClientRetag(SubClient *c, int *flags) {
         }
     }
 
+    subClientHotStore(c);
+
     /* EWMH: Tags */
-    subEwmhSetCardinals(c->win, SUB_EWMH_SUBTLE_CLIENT_TAGS, (long *) &c->tags, 1);
+    subEwmhSetTags(c->win, SUB_EWMH_SUBTLE_CLIENT_TAGS, &c->tags, TAGSUSED(subtle->tags->ndata));
 } /* }}} */
 
 /** subClientResize {{{
@@ -936,14 +1443,44 @@ void subClientResize(SubClient *c, XRectangle *bounds, int size_hints) {
  **/
 
 void subClientRestack(SubClient *c, int dir) {
-    c->dir = dir;
-    subArraySort(subtle->clients, ClientCompare);
-    c->dir = -1;
+    SubClient *sibling = NULL;
+    XWindowChanges wc;
+
+    /* Scan goes top to bottom, keep the order windows already have */
+    if (subtle->flags & SUB_SUBTLE_SCAN) {
+        dir = SUB_CLIENT_RESTACK_DOWN;
+    }
+
+    /* Stacking list is only stale when the order changes */
+    if (ClientLayer(c) != c->layer
+        || (SUB_CLIENT_RESTACK_UP == dir ? NULL != c->above : NULL != c->below))
+    {
+        subtle->list.flags |= SUB_CLIENT_LIST_STACKING;
+    }
+
+    /* Move client to the top or bottom of its layer */
+    ClientUnlink(c);
+    ClientLink(c, dir);
+
+    /* Stack relative to the nearest neighbour only */
+    if ((sibling = ClientSibling(c, SUB_CLIENT_RESTACK_UP == dir ? SUB_CLIENT_RESTACK_DOWN
+                                                                  : SUB_CLIENT_RESTACK_UP)))
+    {
+        wc.stack_mode = SUB_CLIENT_RESTACK_UP == dir ? Above : Below;
+    } else if ((sibling = ClientSibling(c, dir))) {
+        wc.stack_mode = SUB_CLIENT_RESTACK_UP == dir ? Below : Above;
+    }
 
-    subClientPublish(True);
+    if (sibling && !(subtle->flags & SUB_SUBTLE_SCAN)) {
+        wc.sibling = sibling->win;
 
-    subSubtleLogDebugSubtle("Restack: instance=%s, win=%#lx, dir=%s\n", c->instance, c->win,
-                            SUB_CLIENT_RESTACK_DOWN == dir ? "down" : "up");
+        XConfigureWindow(subtle->dpy, c->win, CWSibling | CWStackMode, &wc);
+    }
+
+    subClientPublish();
+
+    subSubtleLogDebugSubtle("Restack: instance=%s, win=%#lx, dir=%s, layer=%d\n", c->instance,
+                            c->win, SUB_CLIENT_RESTACK_DOWN == dir ? "down" : "up", c->layer);
 } /* }}} */
 
 /** subClientArrange {{{
@@ -980,6 +1517,8 @@ void subClientArrange(SubClient *c, int gravityid, int screenid) {
                 c->geom.x = c->geom.x - old_s->geom.x + s->geom.x;
                 c->geom.y = c->geom.y - old_s->geom.y + s->geom.y;
                 c->screenid = screenid;
+
+                ClientMigrate(c);
             }
 
             /* Finally resize window */
@@ -1007,11 +1546,15 @@ void subClientArrange(SubClient *c, int gravityid, int screenid) {
             /* Set values */
             if (-1 != screenid) {
                 c->screenid = screenid;
+
+                ClientMigrate(c);
             }
             if (-1 != gravityid) {
                 c->gravityid = c->gravities[s->viewid] = gravityid;
             }
 
+            subClientHotStore(c);
+
             g = GRAVITY(subArrayGet(subtle->gravities, gravityid));
             old_g = GRAVITY(subArrayGet(subtle->gravities, old_gravity));
 
@@ -1047,6 +1590,9 @@ void subClientArrange(SubClient *c, int gravityid, int screenid) {
 
     /* Remove arrange flag */
     c->flags &= ~SUB_CLIENT_ARRANGE;
+
+    subClientHotStore(c);
+    subClientSpatialUpdate(c);
 } /* }}} */
 
 /** subClientToggle {{{
@@ -1078,7 +1624,7 @@ void subClientToggle(SubClient *c, int flags, int set_gravity) {
         if (c->flags & SUB_CLIENT_MODE_STICK) {
             /* Update highlight urgent client */
             if (c->flags & SUB_CLIENT_MODE_URGENT) {
-                subtle->urgent_tags &= ~c->tags;
+                subTagsRemove(&subtle->urgent_tags, &c->tags);
             }
         } else {
             /* Check if gravity should be set */
@@ -1090,7 +1636,7 @@ void subClientToggle(SubClient *c, int flags, int set_gravity) {
                     SubView *v = VIEW(subtle->views->data[i]);
 
                     /* Check visibility manually */
-                    if (!(v->tags & c->tags) && -1 != c->gravityid) {
+                    if (!subTagsMatch(&v->tags, &c->tags) && -1 != c->gravityid) {
                         c->gravities[i] = c->gravityid;
                     }
                 }
@@ -1105,6 +1651,8 @@ void subClientToggle(SubClient *c, int flags, int set_gravity) {
                 {
                     c->screenid = focus->screenid;
                 } else subScreenCurrent(&c->screenid);
+
+                ClientMigrate(c);
             }
         }
     }
@@ -1144,7 +1692,7 @@ void subClientToggle(SubClient *c, int flags, int set_gravity) {
 
     /* Handle urgent mode */
     if (flags & SUB_CLIENT_MODE_URGENT)
-        subtle->urgent_tags |= c->tags;
+        subTagsAdd(&subtle->urgent_tags, &c->tags);
 
     /* Handle center mode */
     if (flags & SUB_CLIENT_MODE_CENTER) {
@@ -1187,9 +1735,9 @@ void subClientToggle(SubClient *c, int flags, int set_gravity) {
     /* Finally toggle mode flags only */
     c->flags = ((c->flags & ~MODES_ALL) | ((c->flags & MODES_ALL) ^ (flags & MODES_ALL)));
 
-    /* Sort for keeping stacking order */
+    /* Restack for keeping stacking order or when the layer changed */
     if (c->flags & (SUB_CLIENT_MODE_FLOAT | SUB_CLIENT_MODE_FULL | SUB_CLIENT_TYPE_DESKTOP |
-                    SUB_CLIENT_TYPE_DOCK))
+                    SUB_CLIENT_TYPE_DOCK) || (-1 != c->layer && ClientLayer(c) != c->layer))
         subClientRestack(c, SUB_CLIENT_RESTACK_UP);
 
     /* EWMH: State and flags */
@@ -1213,6 +1761,9 @@ void subClientToggle(SubClient *c, int flags, int set_gravity) {
 
     subEwmhSetCardinals(c->win, SUB_EWMH_SUBTLE_CLIENT_FLAGS, (long *) &flags, 1);
 
+    subClientHotStore(c);
+    subClientSpatialUpdate(c);
+
     XSync(subtle->dpy, False); ///< Sync all changes
 
     /* Hook: Mode */
@@ -1443,7 +1994,7 @@ void subClientSetWMHints(SubClient *c, int *flags) {
             /* Copy tags and modes */
             if ((k = CLIENT(subSubtleFind(hints->window_group, CLIENTID)))) {
                 *flags |= (k->flags & MODES_ALL);
-                c->tags |= k->tags;
+                subTagsAdd(&c->tags, &k->tags);
                 c->screenid |= k->screenid;
             }
         }
@@ -1456,6 +2007,8 @@ void subClientSetWMHints(SubClient *c, int *flags) {
         XFree(hints);
     }
 
+    subClientHotStore(c);
+
     subSubtleLogDebugSubtle("SetWMHints\n");
 } /* }}} */
 
@@ -1536,11 +2089,13 @@ void subClientSetTransient(SubClient *c, int *flags) {
         /* Find parent window */
         if ((k = CLIENT(subSubtleFind(trans, CLIENTID)))) {
             *flags |= (k->flags & MODES_ALL);
-            c->tags |= k->tags;
+            subTagsAdd(&c->tags, &k->tags);
             c->screenid |= k->screenid;
         }
     }
 
+    subClientHotStore(c);
+
     subSubtleLogDebugSubtle("SetTransient\n");
 } /* }}} */
 
@@ -1597,6 +2152,8 @@ void subClientSetType(SubClient *c, int *flags) {
         c->flags |= SUB_CLIENT_TYPE_NORMAL;
     }
 
+    subClientHotStore(c);
+
     subSubtleLogDebugSubtle("SetType\n");
 } /* }}} */
 
@@ -1620,7 +2177,7 @@ void subClientClose(SubClient *c) {
 
         subArrayRemove(subtle->clients, (void *) c);
         subClientKill(c);
-        subClientPublish(False);
+        subClientPublish();
 
         subScreenConfigure();
         subScreenUpdate();
@@ -1645,6 +2202,8 @@ void subClientClose(SubClient *c) {
  **/
 
 void subClientKill(SubClient *c) {
+    int i;
+
     assert(c);
 
     /* Hook: Kill */
@@ -1657,9 +2216,25 @@ void subClientKill(SubClient *c) {
     XSelectInput(subtle->dpy, c->win, NoEventMask);
     XDeleteContext(subtle->dpy, c->win, CLIENTID);
 
+    /* Remove from stacking layer, focus history, hot state, spatial index and client list */
+    ClientUnlink(c);
+    ClientForget(c);
+    ClientHotRemove(c);
+
+    subtle->spatial.stale = True;
+
+    for (i = 0; i < subtle->list.nwins; i++) {
+        if (subtle->list.wins[i] == c->win) {
+            memmove(subtle->list.wins + i, subtle->list.wins + i + 1,
+                    (--subtle->list.nwins - i) * sizeof(Window));
+            subtle->list.flags |= (SUB_CLIENT_LIST_REPLACE | SUB_CLIENT_LIST_STACKING);
+            break;
+        }
+    }
+
     /* Remove client tags from urgent tags */
     if (c->flags & SUB_CLIENT_MODE_URGENT) {
-        subtle->urgent_tags &= ~c->tags;
+        subTagsRemove(&subtle->urgent_tags, &c->tags);
     }
 
     /* Tile remaining clients if necessary */
@@ -1696,33 +2271,76 @@ void subClientKill(SubClient *c) {
 /* All */
 
 /** subClientPublish {{{
- * @brief Publish clients
- * @param[in]  restack  Restack windows
+ * @brief Publish stale client lists
  **/
 
-void subClientPublish(int restack) {
+void subClientPublish(void) {
     int i;
-    Window *wins = (Window *) subSharedMemoryAlloc(subtle->clients->ndata, sizeof(Window));
 
-    /* Sort clients from top (=> 0) to bottom */
-    for (i = 0; i < subtle->clients->ndata; i++) {
-        wins[subtle->clients->ndata - 1 - i] = CLIENT(subtle->clients->data[i])->win;
+    /* EWMH: Client list in mapping order, appended on map */
+    if (subtle->list.flags & SUB_CLIENT_LIST_REPLACE) {
+        subEwmhSetWindows(ROOT, SUB_EWMH_NET_CLIENT_LIST, subtle->list.wins, subtle->list.nwins);
     }
 
-    /* EWMH: Client list and client list stacking (same for us) */
-    subEwmhSetWindows(ROOT, SUB_EWMH_NET_CLIENT_LIST, wins, subtle->clients->ndata);
-    subEwmhSetWindows(ROOT, SUB_EWMH_NET_CLIENT_LIST_STACKING, wins, subtle->clients->ndata);
+    /* EWMH: Client list stacking from bottom to top */
+    if (subtle->list.flags & SUB_CLIENT_LIST_STACKING) {
+        int nwins = 0;
+        SubClient *c = NULL;
+        Window *wins = NULL;
+
+        /* Layers are authoritative, clients may be linked before they are added */
+        for (i = 0; i < SUB_CLIENT_LAYERS; i++) {
+            for (c = subtle->layers[i].bottom; c; c = c->above) nwins++;
+        }
+
+        wins = (Window *) subSharedMemoryAlloc(MAX(1, nwins), sizeof(Window));
+
+        for (i = 0, nwins = 0; i < SUB_CLIENT_LAYERS; i++) {
+            for (c = subtle->layers[i].bottom; c; c = c->above) {
+                wins[nwins++] = c->win;
+            }
+        }
 
-    /* Restack windows? We assembled the array anyway. */
-    if (restack) {
-        XRestackWindows(subtle->dpy, wins, subtle->clients->ndata);
+        subEwmhSetWindows(ROOT, SUB_EWMH_NET_CLIENT_LIST_STACKING, wins, nwins);
+
+        free(wins);
     }
 
-    XSync(subtle->dpy, False); ///< Sync all changes
+    subSubtleLogDebugSubtle("Publish: clients=%d, replace=%d, stacking=%d\n",
+                            subtle->clients->ndata,
+                            !!(subtle->list.flags & SUB_CLIENT_LIST_REPLACE),
+                            !!(subtle->list.flags & SUB_CLIENT_LIST_STACKING));
+
+    subtle->list.flags = 0;
+} /* }}} */
 
-    free(wins);
+/** subClientHotStore {{{
+ * @brief Write hot client state through to its slot
+ * @param[in]  c  A #SubClient
+ *
+ * Scans over all clients just need flags, tags, screen and gravity, so
+ * keep them contiguous instead of chasing each #SubClient. Call this
+ * after changing any of them, it also marks the spatial index stale
+ * when the client may have joined or left it.
+ **/
+
+void subClientHotStore(SubClient *c) {
+    assert(c);
+
+    if (-1 == c->slot) return; ///< Not added yet
+
+    /* Spatial index membership depends on tags, stickiness and screen */
+    if (subtle->hot.screenids[c->slot] != c->screenid
+        || (subtle->hot.flags[c->slot] ^ c->flags) & SUB_CLIENT_MODE_STICK
+        || 0 != memcmp(&subtle->hot.tags[c->slot], &c->tags, sizeof(TAGS)))
+    {
+        subtle->spatial.stale = True;
+    }
 
-    subSubtleLogDebugSubtle("Publish: clients=%d, restack=%d\n", subtle->clients->ndata, restack);
+    subtle->hot.flags[c->slot] = c->flags;
+    subtle->hot.tags[c->slot] = c->tags;
+    subtle->hot.screenids[c->slot] = c->screenid;
+    subtle->hot.gravityids[c->slot] = c->gravityid;
 } /* }}} */
 
 // vim:ts=2:bs=2:sw=2:et:fdm=marker
@@ -242,26 +242,35 @@ void subDisplayScan(void) {
 
     assert(subtle);
 
+    /* Replace lists of previous instances */
+    subtle->list.flags |= (SUB_CLIENT_LIST_REPLACE | SUB_CLIENT_LIST_STACKING);
+
     /* Scan for client windows */
     XQueryTree(subtle->dpy, ROOT, &wroot, &parent, &wins, &nwins);
 
-    for (i = 0; i < nwins; i++) {
+    /* Add from top to bottom to keep the topmost one most recent,
+     * each client is linked below the previous one */
+    subtle->flags |= SUB_SUBTLE_SCAN;
+
+    for (i = nwins; 0 < i; i--) {
         SubClient *c = NULL;
         XWindowAttributes attrs;
 
-        XGetWindowAttributes(subtle->dpy, wins[i], &attrs);
+        XGetWindowAttributes(subtle->dpy, wins[i - 1], &attrs);
         switch (attrs.map_state) {
             case IsViewable:
-                if ((c = subClientNew(wins[i])))
+                if ((c = subClientNew(wins[i - 1])))
                     subArrayPush(subtle->clients, (void *) c);
                 break;
             default: break;
         }
     }
 
+    subtle->flags &= ~SUB_SUBTLE_SCAN;
+
     XFree(wins);
 
-    subClientPublish(False);
+    subClientPublish();
 
     subSubtleLogDebugSubtle("Scan\n");
 } /* }}} */
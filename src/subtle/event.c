@@ -30,41 +30,35 @@ int nwatches = 0, nqueue = 0;
 
 /* EventUntag {{{ */
 static void EventUntag(SubClient *c, int id) {
-    int i, tag;
-
-    /* Shift bits */
-    for (i = id; i < subtle->tags->ndata - 1; i++) {
-        tag = (1L << (i + 1));
-
-        if (c->tags & (1L << (i + 2))) { ///< Next bit
-            c->tags |= tag;
-        } else c->tags &= ~tag;
-    }
+    /* Drop tag and shift following ids */
+    subTagsDrop(&c->tags, id);
+    subClientHotStore(c);
 
     /* EWMH: Tags */
-    if (c->flags & SUB_TYPE_CLIENT) {
-        subEwmhSetCardinals(c->win, SUB_EWMH_SUBTLE_CLIENT_TAGS, (long *) &c->tags, 1);
-    }
+    subEwmhSetTags(c->win, SUB_EWMH_SUBTLE_CLIENT_TAGS, &c->tags, TAGSUSED(subtle->tags->ndata));
 } /* }}} */
 
-/* EventFindSublet {{{ */
-static SubPanel *EventFindSublet(int id) {
-    int i = 0, j = 0, idx = 0;
-
-    /* Find sublet in panels */
-    for (i = 0; i < subtle->screens->ndata; i++) {
-        SubScreen *s = SCREEN(subtle->screens->data[i]);
+/* EventTagsRequest {{{ */
+static void EventTagsRequest(XClientMessageEvent *ev, Window win, TAGS *tags) {
+    int i, nwords = MINMAX((int) ev->data.l[2], 1, TAGSWORDS);
+    unsigned long size = 0;
+    long *words = NULL;
 
-        for (j = 0; j < s->panels->ndata; j++) {
-            SubPanel *p = PANEL(s->panels->data[j]);
+    /* Replace whole set, larger sets are passed as property */
+    memset(tags, 0, sizeof(TAGS));
+    tags->words[0] = (unsigned int) ev->data.l[1];
 
-            if (p->flags & SUB_PANEL_SUBLET && !(p->flags & SUB_PANEL_COPY) && idx++ == id) {
-                return p;
-            }
+    if (1 < nwords && (words = (long *) subSharedPropertyGet(subtle->dpy, win, XA_CARDINAL,
+                           subEwmhGet(SUB_EWMH_SUBTLE_TAG_REQUEST), &size)))
+    {
+        for (i = 0; i < nwords && i < (int) size; i++) {
+            tags->words[i] = (unsigned int) words[i];
         }
-    }
 
-    return NULL;
+        subSharedPropertyDelete(subtle->dpy, win, subEwmhGet(SUB_EWMH_SUBTLE_TAG_REQUEST));
+
+        XFree(words);
+    }
 } /* }}} */
 
 /* EventQueuePush {{{ */
@@ -114,50 +108,6 @@ static void EventQueuePop(long value, long type) {
     }
 } /* }}} */
 
-/* EventMatch {{{ */
-static int EventMatch(int type, XRectangle *origin, XRectangle *test) {
-    int cx_origin = 0, cx_test = 0, cy_origin = 0, cy_test = 0, dx = 0, dy = 0;
-
-    /* This check is complicated and consists of three parts:
-     * 1) Calculate window center positions
-     * 2) Check if x/y values decrease in given direction
-     * 3) Check if a corner of one of the rects is close enough to
-     *    a side of the other rect */
-
-    /* Calculate window centers */
-    cx_origin = origin->x + (origin->width / 2);
-    cx_test = test->x + (test->width / 2);
-
-    cy_origin = origin->y + (origin->height / 2);
-    cy_test = test->y + (test->height / 2);
-
-    /* Check geometries */
-    if ((((SUB_GRAB_DIRECTION_LEFT == type && cx_test <= cx_origin)
-        || (SUB_GRAB_DIRECTION_RIGHT == type && cx_test >= cx_origin))
-         && ((cy_test >= origin->y && cy_test <= origin->y + origin->height)
-        || (cy_origin >= test->y && cy_origin <= test->y + test->height)))
-
-        || (((SUB_GRAB_DIRECTION_UP == type && cy_test <= cy_origin)
-        || (SUB_GRAB_DIRECTION_DOWN == type && cy_test >= cy_origin))
-        && ((cx_test >= origin->x && cx_test <= origin->x + origin->width)
-        || (cx_origin >= test->x && cx_origin <= test->x + test->width))))
-    {
-        /* Euclidean distance */
-        dx = abs(cx_origin - cx_test);
-        dy = abs(cy_origin - cy_test);
-
-        /* Zero distance means same dimensions - highest distance */
-        if (0 == dx && 0 == dy)
-            dx = dy = 1L << 15;
-    } else {
-        /* No match - highest distance too */
-        dx = 1L << 15;
-        dy = 1L << 15;
-    }
-
-    return dx + dy;
-} /* }}} */
-
 /* Events */
 
 /* EventColormap {{{ */
@@ -257,6 +207,8 @@ static void EventConfigureRequest(XConfigureRequestEvent *ev) {
             if (ev->value_mask & (CWX | CWY | CWWidth | CWHeight)) {
                 XMoveResizeWindow(subtle->dpy, c->win, c->geom.x, c->geom.y, c->geom.width,
                                   c->geom.height);
+
+                subClientSpatialUpdate(c);
             }
         } else subClientConfigure(c);
     } else { ///< Unmanaged windows
@@ -314,7 +266,7 @@ static void EventDestroy(XDestroyWindowEvent *ev) {
         /* Kill client */
         subArrayRemove(subtle->clients, (void *) c);
         subClientKill(c);
-        subClientPublish(False);
+        subClientPublish();
 
         subScreenConfigure();
         subScreenUpdate();
@@ -348,6 +300,7 @@ static void EventDestroy(XDestroyWindowEvent *ev) {
             /* Mark all windows with leader as dead */
             if (c->leader == ev->window) {
                 c->flags |= SUB_CLIENT_DEAD;
+                subClientHotStore(c);
             }
         }
     }
@@ -357,6 +310,13 @@ static void EventDestroy(XDestroyWindowEvent *ev) {
 
 /* EventExpose {{{ */
 static void EventExpose(XExposeEvent *ev) {
+    SubScreen *s = NULL;
+
+    /* Panel contents are lost, repaint all of it */
+    if ((s = SCREEN(subSubtleFind(ev->window, SCREENID)))) {
+        s->flags |= SUB_SCREEN_DAMAGE;
+    }
+
     if (0 == ev->count) {
         subScreenRender(); ///< Render once
     }
@@ -598,34 +558,7 @@ static void EventGrab(XEvent *ev) {
 
                 /* Check if a window is currently focussed or just select next*/
                 if ((c = CLIENT(subSubtleFind(subtle->windows.focus[0], CLIENTID)))) {
-                    int i, j, match = (1L << 30), distance = 0;
-
-                    /* Iterate once to find a client with smallest distance */
-                    for (i = 0; i < subtle->clients->ndata; i++) {
-                        SubClient *k = CLIENT(subtle->clients->data[i]);
-
-                        /* Check if both clients are different and visible */
-                        if (c != k
-                            && (subtle->visible_tags & k->tags || k->flags & SUB_CLIENT_MODE_STICK))
-                        {
-                            /* Substract stack position index to get top window */
-                            distance = EventMatch(g->data.num, &c->geom, &k->geom) - i;
-
-                            /* Substract history stack position index */
-                            for (j = 1; j < HISTORYSIZE; j++) {
-                                if (subtle->windows.focus[j] == k->win) {
-                                    distance -= (HISTORYSIZE - j);
-                                    break;
-                                }
-                            }
-
-                            /* Finally compare distance */
-                            if (match > distance) {
-                                match = distance;
-                                found = k;
-                            }
-                        }
-                    }
+                    found = subClientSelect(c, g->data.num);
                 } else found = subClientNext(-1, True);
 
                 if (found)
@@ -793,6 +726,7 @@ static void EventMapRequest(XMapRequestEvent *ev) {
     if ((c = CLIENT(subSubtleFind(ev->window, CLIENTID)))) {
         c->flags &= ~SUB_CLIENT_DEAD;
         c->flags |= SUB_CLIENT_ARRANGE;
+        subClientHotStore(c);
 
         subScreenConfigure();
         subScreenUpdate();
@@ -855,7 +789,7 @@ static void EventMessage(XClientMessageEvent *ev) {
 
                         /* Find matching view */
                         for (i = 0; i < subtle->views->ndata; i++) {
-                            if (c && (VIEW(subtle->views->data[i])->tags & c->tags
+                            if (c && (subTagsMatch(&VIEW(subtle->views->data[i])->tags, &c->tags)
                                       || c->flags & SUB_CLIENT_MODE_STICK))
                             {
                                 subViewFocus(VIEW(subtle->views->data[i]), c->screenid, False,
@@ -881,28 +815,34 @@ static void EventMessage(XClientMessageEvent *ev) {
             case SUB_EWMH_SUBTLE_CLIENT_TAGS: /* {{{ */
                 /* Check if client is ready yet otherwise queue it */
                 if ((c = CLIENT(subSubtleFind(ev->data.l[0], CLIENTID)))) {
-                    int i, flags = 0, tags = 0;
+                    int i, flags = 0;
+                    TAGS tags, added;
+
+                    EventTagsRequest(ev, c->win, &tags);
 
                     /* Select only new tags */
-                    tags = (c->tags ^ (int) ev->data.l[1]) & (int) ev->data.l[1];
+                    added = tags;
+                    subTagsRemove(&added, &c->tags);
 
                     /* Remove highlight of tagless, urgent client */
-                    if (0 == tags && c->flags & SUB_CLIENT_MODE_URGENT) {
-                        subtle->urgent_tags &= ~c->tags;
+                    if (subTagsEmpty(&added) && c->flags & SUB_CLIENT_MODE_URGENT) {
+                        subTagsRemove(&subtle->urgent_tags, &c->tags);
                     }
 
                     /* Update tags and assign properties */
-                    for (i = 0; i < 31; i++) {
-                        if (tags & (1L << (i + 1))) {
+                    for (i = 0; i < subtle->tags->ndata; i++) {
+                        if (subTagsCheck(&added, i)) {
                             subClientTag(c, i, &flags);
                         }
                     }
 
                     subClientToggle(c, flags, True); ///< Toggle flags
-                    c->tags = (int) ev->data.l[1]; ///< Write all tags
+                    c->tags = tags; ///< Write all tags
+                    subClientHotStore(c);
 
                     /* EWMH: Tags */
-                    subEwmhSetCardinals(c->win, SUB_EWMH_SUBTLE_CLIENT_TAGS, (long *) &c->tags, 1);
+                    subEwmhSetTags(c->win, SUB_EWMH_SUBTLE_CLIENT_TAGS, &c->tags,
+                                   TAGSUSED(subtle->tags->ndata));
 
                     subScreenConfigure();
 
@@ -922,7 +862,7 @@ static void EventMessage(XClientMessageEvent *ev) {
                 if ((c = CLIENT(subSubtleFind(ev->data.l[0], CLIENTID)))) {
                     int flags = 0;
 
-                    c->tags = 0; ///> Reset tags
+                    memset(&c->tags, 0, sizeof(TAGS)); ///> Reset tags
 
                     subClientRetag(c, &flags);
                     subClientToggle(c, (~c->flags & flags), True); ///< Toggle flags
@@ -942,7 +882,7 @@ static void EventMessage(XClientMessageEvent *ev) {
                         if ((v = VIEW(subArrayGet(subtle->views, (int) ev->data.l[2])))) {
                             c->gravities[(int) ev->data.l[2]] = (int) ev->data.l[1];
 
-                            if (subtle->visible_views & (1L << ((int) ev->data.l[2] + 1))) {
+                            if (subTagsCheck(&subtle->visible_views, (int) ev->data.l[2])) {
                                 printf("DEBUG %s:%d\n", __FILE__, __LINE__);
                                 subClientArrange(c, c->gravities[(int) ev->data.l[2]], c->screenid);
                                 XRaiseWindow(subtle->dpy, c->win);
@@ -1085,7 +1025,7 @@ static void EventMessage(XClientMessageEvent *ev) {
                 }
                 break; /* }}} */
             case SUB_EWMH_SUBTLE_SUBLET_DATA: /* {{{ */
-                if ((p = EventFindSublet((int) ev->data.l[0]))
+                if ((p = subPanelFind((int) ev->data.l[0]))
                     && p->sublet->flags & SUB_SUBLET_DATA)
                 {
                     subRubyCall(SUB_CALL_DATA, p->sublet->instance, NULL);
@@ -1101,7 +1041,7 @@ static void EventMessage(XClientMessageEvent *ev) {
                     sscanf(ev->data.b, "%d#%s", &subletid, name);
 
                     /* Find sublet and state */
-                    if ((p = EventFindSublet(subletid))) {
+                    if ((p = subPanelFind(subletid))) {
                         int styleid = -1;
                         subStyleFind(&subtle->styles.sublets, name, &styleid);
 
@@ -1112,7 +1052,7 @@ static void EventMessage(XClientMessageEvent *ev) {
                 }
                 break; /* }}} */
             case SUB_EWMH_SUBTLE_SUBLET_FLAGS: /* {{{ */
-                if ((p = EventFindSublet((int) ev->data.l[0]))) {
+                if ((p = subPanelFind((int) ev->data.l[0]))) {
                     /* Update visibility */
                     if (ev->data.l[1] & SUB_EWMH_VISIBLE && p->flags & SUB_PANEL_HIDDEN) {
                         p->flags &= ~SUB_PANEL_HIDDEN;
@@ -1126,14 +1066,14 @@ static void EventMessage(XClientMessageEvent *ev) {
                 }
                 break; /* }}} */
             case SUB_EWMH_SUBTLE_SUBLET_UPDATE: /* {{{ */
-                if ((p = EventFindSublet((int) ev->data.l[0]))) {
+                if ((p = subPanelFind((int) ev->data.l[0]))) {
                     subRubyCall(SUB_CALL_RUN, p->sublet->instance, NULL);
                     subScreenUpdate();
                     subScreenRender();
                 }
                 break; /* }}} */
             case SUB_EWMH_SUBTLE_SUBLET_KILL: /* {{{ */
-                if ((p = EventFindSublet((int) ev->data.l[0]))) {
+                if ((p = subPanelFind((int) ev->data.l[0]))) {
                     subRubyUnloadSublet(p);
                     subScreenUpdate();
                     subScreenRender();
@@ -1159,9 +1099,12 @@ static void EventMessage(XClientMessageEvent *ev) {
                     /* Untag views */
                     for (i = 0; i < subtle->views->ndata; i++) { ///< Views
                         v = VIEW(subtle->views->data[i]);
-                        reconf = v->tags & (1L << ((int) ev->data.l[0] + 1));
 
-                        EventUntag(CLIENT(v), (int) ev->data.l[0]);
+                        if (subTagsCheck(&v->tags, (int) ev->data.l[0])) {
+                            reconf = True;
+                        }
+
+                        subTagsDrop(&v->tags, (int) ev->data.l[0]);
                     }
 
                     /* Untag clients */
@@ -1196,12 +1139,11 @@ static void EventMessage(XClientMessageEvent *ev) {
                 break; /* }}} */
             case SUB_EWMH_SUBTLE_VIEW_TAGS: /* {{{ */
                 if ((v = VIEW(subArrayGet(subtle->views, (int) ev->data.l[0])))) {
-                    v->tags = (int) ev->data.l[1]; ///< Action
-
+                    EventTagsRequest(ev, ROOT, &v->tags);
                     subViewPublish();
 
                     /* Reconfigure if view is visible */
-                    if (subtle->visible_views & (1L << (ev->data.l[0] + 1))) {
+                    if (subTagsCheck(&subtle->visible_views, (int) ev->data.l[0])) {
                         subScreenConfigure();
                     }
                 } else
@@ -1227,7 +1169,7 @@ static void EventMessage(XClientMessageEvent *ev) {
                 break; /* }}} */
             case SUB_EWMH_SUBTLE_VIEW_KILL: /* {{{ */
                 if ((v = VIEW(subArrayGet(subtle->views, (int) ev->data.l[0])))) {
-                    int visible = !!(subtle->visible_views & (1L << (ev->data.l[0] + 1)));
+                    int visible = !!(subTagsCheck(&subtle->visible_views, (int) ev->data.l[0]));
 
                     subArrayRemove(subtle->views, (void *) v);
                     subClientDimension((int) ev->data.l[0]); ///< Shrink
@@ -1361,6 +1303,8 @@ static void EventMessage(XClientMessageEvent *ev) {
                 XMoveResizeWindow(subtle->dpy, c->win, c->geom.x, c->geom.y, c->geom.width,
                                   c->geom.height);
 
+                subClientSpatialUpdate(c);
+
                 if (VISIBLE(c)) {
                     subScreenUpdate();
                     subScreenRender();
@@ -1521,7 +1465,7 @@ static void EventUnmap(XUnmapEvent *ev) {
         /*  Kill client */
         subArrayRemove(subtle->clients, (void *) c);
         subClientKill(c);
-        subClientPublish(False);
+        subClientPublish();
 
         subScreenConfigure();
         subScreenUpdate();
@@ -1604,7 +1548,7 @@ void subEventWatchDel(int fd) {
  **/
 
 void subEventLoop(void) {
-    int i, timeout = 1, nevents = 0;
+    int i, timeout = 1, nevents = 0, queued = 0;
     XEvent ev;
     time_t now;
     SubPanel *p = NULL;
@@ -1662,10 +1606,19 @@ void subEventLoop(void) {
             }
         }
 
+        /* Write stale root properties and render panels once per cycle */
+        subEwmhFlush();
+        subScreenFlush();
+
+        /* Replies and blocking writes may have queued events, poll cannot see these */
+        queued = XQLength(subtle->dpy);
+
         /* Data ready on any connection */
-        if (0 < (nevents = poll(watches, nwatches, timeout * 1000))) {
+        if (0 < (nevents = poll(watches, nwatches, queued ? 0 : timeout * 1000)) || queued) {
             for (i = 0; i < nwatches; i++) { ///< Find descriptor
-                if (0 != watches[i].revents) {
+                if (0 != watches[i].revents ||
+                    (queued && watches[i].fd == ConnectionNumber(subtle->dpy)))
+                {
                     if (watches[i].fd == ConnectionNumber(subtle->dpy)) { ///< X events {{{
                         while (XPending(subtle->dpy)) { ///< X events
                             XNextEvent(subtle->dpy, &ev);
@@ -15,12 +15,62 @@
 #include <unistd.h>
 #include "subtle.h"
 
-static Atom atoms[SUB_EWMH_TOTAL];
-
 /* Typedef {{{ */
 typedef struct xembedinfo_t {
     CARD32 version, flags;
-} XEmbedInfo; /* }}} */
+} XEmbedInfo;
+
+typedef struct ewmhroot_t {
+    Atom type; ///< Property type
+    int format, stale, known; ///< Property format, pending and last written flags
+    int npending, nlast; ///< Property number of pending and last written items
+    unsigned char *pending, *last; ///< Property pending and last written data
+} EwmhRoot; /* }}} */
+
+static Atom atoms[SUB_EWMH_TOTAL];
+static EwmhRoot roots[SUB_EWMH_TOTAL];
+
+/* Private */
+
+/* EwmhRootSet {{{ */
+static void EwmhRootSet(SubEwmh e, Atom type, int format, unsigned char *data, int nitems,
+                        int mode)
+{
+    EwmhRoot *r = &roots[e];
+    int size = 32 == format ? sizeof(long) : sizeof(char);
+
+    /* Append directly when nothing is pending */
+    if (PropModeAppend == mode && !r->stale) {
+        XChangeProperty(subtle->dpy, ROOT, atoms[e], type, format, PropModeAppend, data,
+                        nitems);
+
+        /* Keep last written data in sync */
+        if (r->known) {
+            r->last = (unsigned char *) subSharedMemoryRealloc(r->last,
+                                                               (r->nlast + nitems + 1) * size);
+            memcpy(r->last + r->nlast * size, data, nitems * size);
+            r->nlast += nitems;
+        }
+
+        return;
+    }
+
+    /* Replace or extend pending data */
+    if (PropModeReplace == mode) {
+        r->npending = 0;
+    }
+
+    r->pending = (unsigned char *) subSharedMemoryRealloc(r->pending,
+                                                          (r->npending + nitems + 1) * size);
+    memcpy(r->pending + r->npending * size, data, nitems * size);
+
+    r->npending += nitems;
+    r->type = type;
+    r->format = format;
+    r->stale = True;
+} /* }}} */
+
+/* Public */
 
 /** subEwmhInit {{{
  * @brief Init and register ICCCM/EWMH atoms
@@ -69,7 +119,8 @@ void subEwmhInit(void) {
                  "SUBTLE_CLIENT_TAGS", "SUBTLE_CLIENT_RETAG", "SUBTLE_CLIENT_GRAVITY",
                  "SUBTLE_CLIENT_SCREEN", "SUBTLE_CLIENT_FLAGS", "SUBTLE_GRAVITY_NEW",
                  "SUBTLE_GRAVITY_FLAGS", "SUBTLE_GRAVITY_LIST", "SUBTLE_GRAVITY_KILL",
-                 "SUBTLE_TAG_NEW", "SUBTLE_TAG_LIST", "SUBTLE_TAG_KILL", "SUBTLE_TRAY_LIST",
+                 "SUBTLE_TAG_NEW", "SUBTLE_TAG_LIST", "SUBTLE_TAG_KILL", "SUBTLE_TAG_REQUEST",
+                 "SUBTLE_TRAY_LIST",
                  "SUBTLE_VIEW_NEW", "SUBTLE_VIEW_TAGS", "SUBTLE_VIEW_STYLE", "SUBTLE_VIEW_ICONS",
                  "SUBTLE_VIEW_KILL", "SUBTLE_SUBLET_UPDATE", "SUBTLE_SUBLET_DATA",
                  "SUBTLE_SUBLET_STYLE", "SUBTLE_SUBLET_FLAGS", "SUBTLE_SUBLET_LIST",
@@ -208,8 +259,25 @@ long subEwmhGetXEmbedState(Window win) {
  **/
 
 void subEwmhSetWindows(Window win, SubEwmh e, Window *values, int size) {
-    XChangeProperty(subtle->dpy, win, atoms[e], XA_WINDOW, 32, PropModeReplace,
-                    (unsigned char *) values, size);
+    if (ROOT == win) {
+        EwmhRootSet(e, XA_WINDOW, 32, (unsigned char *) values, size, PropModeReplace);
+    } else XChangeProperty(subtle->dpy, win, atoms[e], XA_WINDOW, 32, PropModeReplace,
+                           (unsigned char *) values, size);
+} /* }}} */
+
+/** subEwmhAppendWindows {{{
+ * @brief Append to window property
+ * @param[in]  win     Window
+ * @param[in]  e       A #SubEwmh
+ * @param[in]  values  Window list
+ * @param[in]  size    Size of the list
+ **/
+
+void subEwmhAppendWindows(Window win, SubEwmh e, Window *values, int size) {
+    if (ROOT == win) {
+        EwmhRootSet(e, XA_WINDOW, 32, (unsigned char *) values, size, PropModeAppend);
+    } else XChangeProperty(subtle->dpy, win, atoms[e], XA_WINDOW, 32, PropModeAppend,
+                           (unsigned char *) values, size);
 } /* }}} */
 
 /** subEwmhSetCardinals {{{
@@ -221,8 +289,10 @@ void subEwmhSetWindows(Window win, SubEwmh e, Window *values, int size) {
  **/
 
 void subEwmhSetCardinals(Window win, SubEwmh e, long *values, int size) {
-    XChangeProperty(subtle->dpy, win, atoms[e], XA_CARDINAL, 32, PropModeReplace,
-                    (unsigned char *) values, size);
+    if (ROOT == win) {
+        EwmhRootSet(e, XA_CARDINAL, 32, (unsigned char *) values, size, PropModeReplace);
+    } else XChangeProperty(subtle->dpy, win, atoms[e], XA_CARDINAL, 32, PropModeReplace,
+                           (unsigned char *) values, size);
 } /* }}} */
 
 /** subEwmhSetString {{{
@@ -233,8 +303,56 @@ void subEwmhSetCardinals(Window win, SubEwmh e, long *values, int size) {
  **/
 
 void subEwmhSetString(Window win, SubEwmh e, char *value) {
-    XChangeProperty(subtle->dpy, win, atoms[e], atoms[SUB_EWMH_UTF8], 8, PropModeReplace,
-                    (unsigned char *) value, strlen(value));
+    if (ROOT == win) {
+        EwmhRootSet(e, atoms[SUB_EWMH_UTF8], 8, (unsigned char *) value, strlen(value),
+                    PropModeReplace);
+    } else XChangeProperty(subtle->dpy, win, atoms[e], atoms[SUB_EWMH_UTF8], 8, PropModeReplace,
+                           (unsigned char *) value, strlen(value));
+} /* }}} */
+
+/** subEwmhSetStrings {{{
+ * @brief Change string list property
+ * @param[in]  win    Window
+ * @param[in]  e      A #SubEwmh
+ * @param[in]  list   String list
+ * @param[in]  nlist  Number of strings
+ **/
+
+void subEwmhSetStrings(Window win, SubEwmh e, char **list, int nlist) {
+    XTextProperty text = {0};
+
+    /* Convert list to multibyte text property */
+    XmbTextListToTextProperty(subtle->dpy, list, nlist, XUTF8StringStyle, &text);
+
+    if (ROOT == win) {
+        EwmhRootSet(e, text.encoding, text.format, text.value, text.nitems, PropModeReplace);
+    } else XChangeProperty(subtle->dpy, win, atoms[e], text.encoding, text.format,
+                           PropModeReplace, text.value, text.nitems);
+
+    if (text.value) {
+        XFree(text.value);
+    }
+} /* }}} */
+
+/** subEwmhSetTags {{{
+ * @brief Change tag set property
+ *
+ * The first word keeps the layout of the former single cardinal,
+ * further words are only appended when there are enough tags.
+ *
+ * @param[in]  win     Window
+ * @param[in]  e       A #SubEwmh
+ * @param[in]  tags    A #SubTags set
+ * @param[in]  nwords  Number of words to set
+ **/
+
+void subEwmhSetTags(Window win, SubEwmh e, TAGS *tags, int nwords) {
+    long values[TAGSWORDS] = {0};
+
+    nwords = MINMAX(nwords, 1, TAGSWORDS);
+
+    subTagsEncode(tags, values, nwords);
+    subEwmhSetCardinals(win, e, values, nwords);
 } /* }}} */
 
 /** subEwmhSetWMState {{{
@@ -346,11 +464,56 @@ int subEwmhMessage(Window win, SubEwmh e, long mask, long data0, long data1, lon
     return XSendEvent(subtle->dpy, win, False, mask, (XEvent *) &ev);
 } /* }}} */
 
+/** subEwmhFlush {{{
+ * @brief Write stale root properties once and skip unchanged values
+ **/
+
+void subEwmhFlush(void) {
+    int i, size = 0, nwrites = 0;
+
+    for (i = 0; i < SUB_EWMH_TOTAL; i++) {
+        EwmhRoot *r = &roots[i];
+        unsigned char *swap = NULL;
+
+        if (!r->stale) continue;
+
+        r->stale = False;
+        size = 32 == r->format ? sizeof(long) : sizeof(char);
+
+        /* Skip unchanged values */
+        if (r->known && r->nlast == r->npending
+            && 0 == memcmp(r->last, r->pending, r->npending * size))
+            continue;
+
+        XChangeProperty(subtle->dpy, ROOT, atoms[i], r->type, r->format, PropModeReplace,
+                        r->pending, r->npending);
+
+        /* Keep written data for comparison */
+        swap = r->last;
+        r->last = r->pending;
+        r->pending = swap;
+        r->nlast = r->npending;
+        r->npending = 0;
+        r->known = True;
+
+        nwrites++;
+    }
+
+    /* Send writes before the event loop waits */
+    if (0 < nwrites) {
+        XFlush(subtle->dpy);
+
+        subSubtleLogDebugSubtle("Flush: writes=%d\n", nwrites);
+    }
+} /* }}} */
+
 /** subEwmhFinish {{{
  * @brief Delete set ICCCM/EWMH atoms
  **/
 
 void subEwmhFinish(void) {
+    int i;
+
     /* Delete root properties on real shutdown */
     if (subtle->flags & SUB_SUBTLE_EWMH) {
         /* EWMH properties */
@@ -379,6 +542,16 @@ void subEwmhFinish(void) {
         subSharedPropertyDelete(subtle->dpy, ROOT, subEwmhGet(SUB_EWMH_SUBTLE_VISIBLE_TAGS));
     }
 
+    /* Free root property data */
+    for (i = 0; i < SUB_EWMH_TOTAL; i++) {
+        if (roots[i].pending) {
+            free(roots[i].pending);
+        }
+        if (roots[i].last) {
+            free(roots[i].last);
+        }
+    }
+
     subSubtleLogDebugSubtle("Finish\n");
 } /* }}} */
 
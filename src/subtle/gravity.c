@@ -13,6 +13,11 @@
 #include <X11/Xresource.h>
 #include "subtle.h"
 
+/* GravityKey {{{ */
+static unsigned long GravityKey(void *elem) {
+    return GRAVITY(elem)->quark;
+} /* }}} */
+
 /* Method */
 
 /** subGravityNew {{{
@@ -92,7 +97,7 @@ int subGravityFind(const char *name, int quark) {
     int found = -1;
 
     if (0 < subtle->gravities->ndata) {
-        int i, hash = 0;
+        int id, pos = 0, hash = 0;
 
         /* Get quark */
         if (name) {
@@ -101,14 +106,13 @@ int subGravityFind(const char *name, int quark) {
             hash = quark;
         }
 
-        for (i = 0; i < subtle->gravities->ndata; i++) {
-            SubGravity *g = GRAVITY(subtle->gravities->data[i]);
+        if (!subtle->indices.gravities) {
+            subtle->indices.gravities = subIndexNew(subtle->gravities, GravityKey);
+        }
 
-            /* Compare quarks */
-            if (g->quark == hash) {
-                found = i;
-                break;
-            }
+        /* Quarks are unique, so the first hit is the gravity */
+        if (-1 != (id = subIndexFind(subtle->indices.gravities, hash, &pos))) {
+            found = id;
         }
     }
 
@@ -141,8 +145,7 @@ void subGravityPublish(void) {
     }
 
     /* EWMH: Gravity list and geometries */
-    subSharedPropertySetStrings(subtle->dpy, ROOT, subEwmhGet(SUB_EWMH_SUBTLE_GRAVITY_LIST),
-                                gravities, subtle->gravities->ndata);
+    subEwmhSetStrings(ROOT, SUB_EWMH_SUBTLE_GRAVITY_LIST, gravities, subtle->gravities->ndata);
 
     /* Tidy up */
     for (i = 0; i < subtle->gravities->ndata; i++) {
@@ -15,8 +15,30 @@
 #define STYLE_FONT_Y(S, F)                                                                         \
     ((subtle->ph - STYLE_HEIGHT((S))) - F->height) / 2 + F->y + STYLE_TOP((S));
 
-/* PanelDrawRect {{{ */
-static void PanelDrawRect(Drawable drawable, int x, int width, SubStyle *s) {
+#define PANEL_ASSETS 128 ///< Number of cached panel assets
+
+typedef struct panelasset_t { /* {{{ */
+    unsigned long key; ///< Asset key
+    Pixmap pixmap, source; ///< Asset pixmap, icon it was drawn from
+} PanelAsset; /* }}} */
+
+static PanelAsset assets[PANEL_ASSETS];
+static unsigned long generation = 0;
+static SubPanel **sublets = NULL; ///< Published sublets by id
+static int nsublets = 0;
+
+/* PanelStyleHash {{{ */
+static unsigned long PanelStyleHash(unsigned long hash, SubStyle *s) {
+    hash = subSharedHash(hash, &s->fg, 7 * sizeof(long)); ///< Colors
+    hash = subSharedHash(hash, &s->border, 3 * sizeof(SubSides)); ///< Sides
+    hash = subSharedHash(hash, &s->font, sizeof(s->font));
+    hash = subSharedHash(hash, &s->separator, sizeof(s->separator));
+
+    return hash;
+} /* }}} */
+
+/* PanelFillRect {{{ */
+static void PanelFillRect(Drawable drawable, int x, int width, SubStyle *s) {
     if (0 >= width) {
         return;
     }
@@ -51,14 +73,83 @@ static void PanelDrawRect(Drawable drawable, int x, int width, SubStyle *s) {
                    s->border.left, subtle->ph - mh);
 } /* }}} */
 
+/* PanelDrawRect {{{ */
+static void PanelDrawRect(Drawable drawable, int x, int width, SubStyle *s) {
+    int mw = s->margin.left + s->margin.right;
+    int mh = s->margin.top + s->margin.bottom;
+    unsigned long key = 0;
+    Pixmap pixmap = None;
+
+    /* Margins show the panel background, so only the rect is cached */
+    if (0 >= width - mw || 0 >= subtle->ph - mh) {
+        PanelFillRect(drawable, x, width, s);
+
+        return;
+    }
+
+    key = subSharedHash(0, "rect", 4);
+    key = subSharedHash(key, &width, sizeof(width));
+    key = PanelStyleHash(key, s);
+
+    if (subPanelAsset(key, width, subtle->ph, None, &pixmap)) {
+        PanelFillRect(pixmap, 0, width, s);
+    }
+
+    XCopyArea(subtle->dpy, pixmap, drawable, subtle->gcs.draw, s->margin.left, s->margin.top,
+              width - mw, subtle->ph - mh, x + s->margin.left, s->margin.top);
+} /* }}} */
+
 /* PanelDrawSeparator {{{ */
 static void PanelDrawSeparator(int x, SubStyle *s, Drawable drawable) {
-    /* Set window background and border*/
-    PanelDrawRect(drawable, x, s->separator->width, s);
+    int mw = s->margin.left + s->margin.right;
+    int mh = s->margin.top + s->margin.bottom;
+    unsigned long key = 0;
+    Pixmap pixmap = None;
+
+    if (0 >= s->separator->width - mw || 0 >= subtle->ph - mh) {
+        return;
+    }
+
+    key = subSharedHash(0, "separator", 9);
+    key = PanelStyleHash(key, s);
 
-    subSharedDrawString(subtle->dpy, subtle->gcs.draw, s->font, drawable, x + STYLE_LEFT((*s)),
-                        s->font->y + STYLE_TOP((*s)), s->fg, s->bg, s->separator->string,
-                        strlen(s->separator->string));
+    /* Render string once */
+    if (subPanelAsset(key, s->separator->width, subtle->ph, None, &pixmap)) {
+        PanelFillRect(pixmap, 0, s->separator->width, s);
+
+        subSharedDrawString(subtle->dpy, subtle->gcs.draw, s->font, pixmap, STYLE_LEFT((*s)),
+                            s->font->y + STYLE_TOP((*s)), s->fg, s->bg, s->separator->string,
+                            strlen(s->separator->string));
+    }
+
+    XCopyArea(subtle->dpy, pixmap, drawable, subtle->gcs.draw, s->margin.left, s->margin.top,
+              s->separator->width - mw, subtle->ph - mh, x + s->margin.left, s->margin.top);
+} /* }}} */
+
+/* PanelDrawIcon {{{ */
+static void PanelDrawIcon(Drawable drawable, int x, int y, SubIcon *i, long fg, long bg) {
+    unsigned long key = 0;
+    Pixmap pixmap = None;
+
+    /* Only bitmaps need to be colored */
+    if (!i->bitmap) {
+        subSharedDrawIcon(subtle->dpy, subtle->gcs.draw, drawable, x, y, i->width, i->height,
+                          fg, bg, i->pixmap, i->bitmap);
+
+        return;
+    }
+
+    key = subSharedHash(0, "icon", 4);
+    key = subSharedHash(key, &i->pixmap, sizeof(i->pixmap));
+    key = subSharedHash(key, &fg, sizeof(fg));
+    key = subSharedHash(key, &bg, sizeof(bg));
+
+    if (subPanelAsset(key, i->width, i->height, i->pixmap, &pixmap)) {
+        subSharedDrawIcon(subtle->dpy, subtle->gcs.draw, pixmap, 0, 0, i->width, i->height,
+                          fg, bg, i->pixmap, i->bitmap);
+    }
+
+    XCopyArea(subtle->dpy, pixmap, drawable, subtle->gcs.draw, 0, 0, i->width, i->height, x, y);
 } /* }}} */
 
 /* PanelClientModes {{{ */
@@ -90,39 +181,24 @@ void PanelClientModes(SubClient *c, char *buf, int *width) {
 } /* }}} */
 
 /* PanelViewStyle {{{ */
-static void PanelViewStyle(SubView *v, int idx, int focus, SubStyle *s) {
-    /* Select style */
-    if (subtle->styles.views.styles) {
-        SubStyle *style = NULL;
-
-        subStyleReset(s, -1);
-
-        /* Pick base style */
-        if (!(style = subArrayGet(subtle->styles.views.styles, v->styleid))) {
-            if (subtle->styles.focus && focus) {
-                style = subtle->styles.focus;
-            } else if (subtle->styles.occupied && subtle->client_tags & v->tags) {
-                style = subtle->styles.occupied;
-            }
-        }
-
-        /* Merge base style or default */
-        subStyleMerge(s, !style ? &subtle->styles.views : style);
-
-        /* Apply modifiers */
-        if (subtle->styles.urgent && subtle->urgent_tags & v->tags) {
-            subStyleMerge(s, subtle->styles.urgent);
-        }
-
-        if (subtle->styles.visible) {
-            if (subtle->visible_views & (1L << (idx + 1))) {
-                subStyleMerge(s, subtle->styles.visible);
-            }
-        }
+static SubStyle *PanelViewStyle(SubView *v, int idx, int focus) {
+    int state = 0;
 
-    } else {
-        subStyleMerge(s, &subtle->styles.views);
+    /* Collect view state */
+    if (focus) {
+        state |= SUB_STYLE_STATE_FOCUS;
+    }
+    if (subTagsMatch(&subtle->client_tags, &v->tags)) {
+        state |= SUB_STYLE_STATE_OCCUPIED;
     }
+    if (subTagsMatch(&subtle->urgent_tags, &v->tags)) {
+        state |= SUB_STYLE_STATE_URGENT;
+    }
+    if (subTagsCheck(&subtle->visible_views, idx)) {
+        state |= SUB_STYLE_STATE_VISIBLE;
+    }
+
+    return subStyleView(v->styleid, state);
 } /* }}} */
 
 /* PanelSubletStyle {{{ */
@@ -137,6 +213,158 @@ static SubStyle *PanelSubletStyle(SubPanel *p) {
     return s ? s : &subtle->styles.sublets;
 } /* }}} */
 
+/* PanelInputs {{{ */
+static unsigned long PanelInputs(SubPanel *p) {
+    int i;
+    unsigned long hash = 0;
+    SubClient *c = NULL;
+
+    hash = subSharedHash(hash, &subtle->generation, sizeof(subtle->generation));
+
+    /* Collect everything the measurement depends on */
+    switch (p->flags & (SUB_PANEL_KEYCHAIN | SUB_PANEL_TITLE | SUB_PANEL_VIEWS)) {
+        case SUB_PANEL_KEYCHAIN: /* {{{ */
+            if (p->keychain && p->keychain->keys) {
+                hash = subSharedHash(hash, p->keychain->keys, p->keychain->len);
+            }
+            break; /* }}} */
+        case SUB_PANEL_TITLE: /* {{{ */
+            if ((c = CLIENT(subSubtleFind(subtle->windows.focus[0], CLIENTID)))) {
+                FLAGS flags = c->flags & (MODES_ALL | SUB_CLIENT_TYPE_DESKTOP | SUB_CLIENT_DEAD);
+
+                hash = subSharedHash(hash, &c->win, sizeof(c->win));
+                hash = subSharedHash(hash, &flags, sizeof(flags));
+                hash = subSharedHash(hash, c->name, strlen(c->name));
+            }
+            break; /* }}} */
+        case SUB_PANEL_VIEWS: /* {{{ */
+            hash = subSharedHash(hash, &p->screen->viewid, sizeof(p->screen->viewid));
+            hash = subSharedHash(hash, &subtle->client_tags, sizeof(TAGS));
+            hash = subSharedHash(hash, &subtle->urgent_tags, sizeof(TAGS));
+            hash = subSharedHash(hash, &subtle->visible_views, sizeof(TAGS));
+            hash = subSharedHash(hash, &subtle->views->ndata, sizeof(subtle->views->ndata));
+
+            for (i = 0; i < subtle->views->ndata; i++) {
+                SubView *v = VIEW(subtle->views->data[i]);
+
+                hash = subSharedHash(hash, &v->styleid, sizeof(v->styleid));
+                hash = subSharedHash(hash, &v->flags, sizeof(v->flags));
+                hash = subSharedHash(hash, v->name, strlen(v->name));
+            }
+            break; /* }}} */
+        default:
+            return 0; ///< Cheap to measure
+    }
+
+    return hash;
+} /* }}} */
+
+/* PanelSubletContent {{{ */
+static unsigned long PanelSubletContent(unsigned long hash, SubSublet *sublet) {
+    int i;
+
+    hash = subSharedHash(hash, &sublet->styleid, sizeof(sublet->styleid));
+
+    /* Icons are compared by id, the serial catches redraws */
+    if (sublet->text) {
+        hash = subSharedHash(hash, &sublet->text->serial, sizeof(sublet->text->serial));
+    }
+
+    for (i = 0; sublet->text && i < sublet->text->nitems; i++) {
+        SubTextItem *item = &sublet->text->items[i];
+
+        if (item->flags & SUB_TEXT_EMPTY) {
+            break;
+        }
+
+        hash = subSharedHash(hash, &item->flags, sizeof(item->flags));
+        hash = subSharedHash(hash, &item->color, sizeof(item->color));
+
+        if (item->flags & (SUB_TEXT_BITMAP | SUB_TEXT_PIXMAP)) {
+            hash = subSharedHash(hash, &item->data.num, sizeof(item->data.num));
+        } else {
+            hash = subSharedHash(hash, item->data.string, item->len);
+        }
+    }
+
+    return hash;
+} /* }}} */
+
+/* PanelSubletDraw {{{ */
+static void PanelSubletDraw(SubPanel *p, SubStyle *s, Drawable drawable, int x) {
+    int y = STYLE_FONT_Y((*s), s->font);
+
+    /* Set window background and border*/
+    PanelDrawRect(drawable, x, p->width, s);
+
+    /* Render text parts */
+    subTextRender(p->sublet->text, s->font, subtle->gcs.draw, drawable, x + STYLE_LEFT((*s)), y,
+                  s->fg, s->icon, s->bg);
+} /* }}} */
+
+/* PanelSubletCopy {{{ */
+static void PanelSubletCopy(SubPanel *p, SubStyle *s, Drawable drawable) {
+    int mw = s->margin.left + s->margin.right, mh = s->margin.top + s->margin.bottom;
+    unsigned long content = 0;
+
+    /* Margins show the panel background, so only the rect is shared */
+    if (0 >= p->width - mw || 0 >= subtle->ph - mh) {
+        PanelSubletDraw(p, s, drawable, p->x);
+
+        return;
+    }
+
+    content = subSharedHash(0, &subtle->generation, sizeof(subtle->generation));
+    content = subSharedHash(content, &p->width, sizeof(p->width));
+    content = PanelSubletContent(content, p->sublet);
+
+    /* Render once for all copies */
+    if (content != p->sublet->content || None == p->sublet->pixmap) {
+        if (p->sublet->pixmap) {
+            subSharedDrawForget(subtle->dpy, p->sublet->pixmap);
+            XFreePixmap(subtle->dpy, p->sublet->pixmap);
+        }
+
+        p->sublet->pixmap = XCreatePixmap(subtle->dpy, ROOT, p->width, subtle->ph,
+                                          XDefaultDepth(subtle->dpy, DefaultScreen(subtle->dpy)));
+        p->sublet->content = content;
+
+        PanelSubletDraw(p, s, p->sublet->pixmap, 0);
+    }
+
+    XCopyArea(subtle->dpy, p->sublet->pixmap, drawable, subtle->gcs.draw, s->margin.left,
+              s->margin.top, p->width - mw, subtle->ph - mh, p->x + s->margin.left, s->margin.top);
+} /* }}} */
+
+/* PanelContent {{{ */
+static unsigned long PanelContent(SubPanel *p) {
+    int visible = False;
+    unsigned long hash = 0;
+    SubClient *c = NULL;
+
+    hash = subSharedHash(PanelInputs(p), &subtle->generation, sizeof(subtle->generation));
+    hash = subSharedHash(hash, &p->flags, sizeof(p->flags));
+
+    /* Collect everything the drawing depends on beyond measuring */
+    switch (p->flags & (SUB_PANEL_ICON | SUB_PANEL_SUBLET | SUB_PANEL_TITLE)) {
+        case SUB_PANEL_ICON: /* {{{ */
+            hash = subSharedHash(hash, &p->icon->pixmap, sizeof(p->icon->pixmap));
+            break; /* }}} */
+        case SUB_PANEL_SUBLET: /* {{{ */
+            hash = PanelSubletContent(hash, p->sublet);
+            break; /* }}} */
+        case SUB_PANEL_TITLE: /* {{{ */
+            if ((c = CLIENT(subSubtleFind(subtle->windows.focus[0], CLIENTID)))) {
+                visible = VISIBLE(c);
+            }
+
+            hash = subSharedHash(hash, &visible, sizeof(visible));
+            break; /* }}} */
+    }
+
+    return hash;
+} /* }}} */
+
 /* Public */
 
 /** subPanelNew {{{
@@ -181,8 +409,26 @@ SubPanel *subPanelNew(int type) {
  **/
 
 void subPanelUpdate(SubPanel *p) {
+    unsigned long inputs = 0;
+
     assert(p);
 
+    /* Skip measuring when nothing changed */
+    if (0 != (inputs = PanelInputs(p)) && inputs == p->inputs) {
+        /* Restore view widths, they are shared between screens */
+        if (p->flags & SUB_PANEL_VIEWS && p->widths) {
+            int i;
+
+            for (i = 0; i < subtle->views->ndata; i++) {
+                VIEW(subtle->views->data[i])->width = p->widths[i];
+            }
+        }
+
+        return;
+    }
+
+    p->inputs = inputs;
+
     /* Handle panel item type */
     switch (p->flags & (SUB_PANEL_TRAY | SUB_PANEL_ICON | SUB_PANEL_KEYCHAIN | SUB_PANEL_SUBLET |
                         SUB_PANEL_TITLE | SUB_PANEL_VIEWS))
@@ -191,9 +437,9 @@ void subPanelUpdate(SubPanel *p) {
             p->width = 0; ///< Reset width
 
             if (0 < subtle->trays->ndata) {
-                int i;
+                int i, height = subtle->ph - STYLE_HEIGHT(subtle->styles.tray);
 
-                /* Resize every tray */
+                /* Resize trays only when their geometry changed */
                 for (i = 0; i < subtle->trays->ndata; i++) {
                     SubTray *t = TRAY(subtle->trays->data[i]);
 
@@ -201,15 +447,30 @@ void subPanelUpdate(SubPanel *p) {
                         continue;
                     }
 
-                    XMapWindow(subtle->dpy, t->win);
-                    XMoveResizeWindow(subtle->dpy, t->win, p->width, 0, t->width,
-                                      subtle->ph - STYLE_HEIGHT(subtle->styles.tray));
+                    if (t->geom.x != p->width || t->geom.width != t->width
+                        || t->geom.height != height)
+                    {
+                        t->geom.x = p->width;
+                        t->geom.width = t->width;
+                        t->geom.height = height;
+
+                        XMoveResizeWindow(subtle->dpy, t->win, t->geom.x, 0, t->geom.width,
+                                          t->geom.height);
+                    }
+
+                    if (!(t->flags & SUB_TRAY_MAPPED)) {
+                        t->flags |= SUB_TRAY_MAPPED;
+
+                        XMapWindow(subtle->dpy, t->win);
+                    }
 
                     p->width += t->width;
                 }
 
                 p->width += STYLE_WIDTH(subtle->styles.tray); ///< Add style width
-            } else {
+            } else if (0 < subtle->tray.width) {
+                subtle->tray.width = 0; ///< Reset geometry
+
                 XUnmapWindow(subtle->dpy, subtle->windows.tray);
             }
             break; /* }}} */
@@ -275,31 +536,30 @@ void subPanelUpdate(SubPanel *p) {
 
             if (0 < subtle->views->ndata) {
                 int i;
-                SubStyle s = {.flags = SUB_TYPE_STYLE, .min = -1, .fg = -1, .bg = -1, .icon = -1,
-                              .top = -1, .right = -1, .bottom = -1, .left = -1,
-                              .border = {-1}, .padding = {-1}, .margin = {-1}};
+                SubStyle *s = NULL;
 
                 /* Update for each view */
                 for (i = 0; i < subtle->views->ndata; i++) {
                     SubView *v = VIEW(subtle->views->data[i]);
 
                     /* Skip dynamic views */
-                    if (v->flags & SUB_VIEW_DYNAMIC && !(subtle->client_tags & v->tags))
+                    if (v->flags & SUB_VIEW_DYNAMIC
+                        && !subTagsMatch(&subtle->client_tags, &v->tags))
                         continue;
 
-                    PanelViewStyle(v, i, (p->screen->viewid == i), &s);
+                    s = PanelViewStyle(v, i, (p->screen->viewid == i));
 
                     /* Update view width */
                     if (v->flags & SUB_VIEW_ICON_ONLY) {
-                        v->width = v->icon->width + STYLE_WIDTH((s));
+                        v->width = v->icon->width + STYLE_WIDTH((*s));
                     } else {
-                        v->width = subSharedStringWidth(subtle->dpy, s.font, v->name,
+                        v->width = subSharedStringWidth(subtle->dpy, s->font, v->name,
                                                         strlen(v->name), NULL, NULL, True) +
-                                   STYLE_WIDTH((s)) + (v->icon ? v->icon->width + 3 : 0);
+                                   STYLE_WIDTH((*s)) + (v->icon ? v->icon->width + 3 : 0);
                     }
 
                     /* Ensure panel min width */
-                    p->width += MAX(s.min, v->width);
+                    p->width += MAX(s->min, v->width);
                 }
 
                 /* Add width of view separator if any */
@@ -307,6 +567,14 @@ void subPanelUpdate(SubPanel *p) {
                     p->width +=
                             (subtle->views->ndata - 1) * subtle->styles.view_sep->separator->width;
                 }
+
+                /* Keep view widths for unchanged updates */
+                p->widths = (int *) subSharedMemoryRealloc(p->widths,
+                                                           subtle->views->ndata * sizeof(int));
+
+                for (i = 0; i < subtle->views->ndata; i++) {
+                    p->widths[i] = VIEW(subtle->views->data[i])->width;
+                }
             }
             break; /* }}} */
     }
@@ -342,10 +610,8 @@ void subPanelRender(SubPanel *p, Drawable drawable) {
                 y = subtle->styles.separator.font->y + STYLE_TOP(subtle->styles.separator);
                 icony = p->icon->height > y ? subtle->styles.separator.margin.top : y - p->icon->height;
 
-                subSharedDrawIcon(subtle->dpy, subtle->gcs.draw, drawable,
-                                  p->x + 2 + subtle->styles.separator.padding.left, icony,
-                                  p->icon->width, p->icon->height, subtle->styles.sublets.fg,
-                                  subtle->styles.sublets.bg, p->icon->pixmap, p->icon->bitmap);
+                PanelDrawIcon(drawable, p->x + 2 + subtle->styles.separator.padding.left, icony,
+                              p->icon, subtle->styles.sublets.fg, subtle->styles.sublets.bg);
             }
         break; /* }}} */
         case SUB_PANEL_KEYCHAIN: /* {{{ */
@@ -362,14 +628,12 @@ void subPanelRender(SubPanel *p, Drawable drawable) {
             {
                 SubStyle *s = PanelSubletStyle(p);
 
-                /* Set window background and border*/
-                PanelDrawRect(drawable, p->x, p->width, s);
-
-                int y = STYLE_FONT_Y((*s), s->font);
-
-                /* Render text parts */
-                subTextRender(p->sublet->text, s->font, subtle->gcs.draw, drawable,
-                              p->x + STYLE_LEFT((*s)), y, s->fg, s->icon, s->bg);
+                /* Blit sublets shown on several panels */
+                if (p->sublet->flags & SUB_SUBLET_SHARED) {
+                    PanelSubletCopy(p, s, drawable);
+                } else {
+                    PanelSubletDraw(p, s, drawable, p->x);
+                }
             }
             break; /* }}} */
         case SUB_PANEL_TITLE: /* {{{ */
@@ -409,9 +673,7 @@ void subPanelRender(SubPanel *p, Drawable drawable) {
         case SUB_PANEL_VIEWS: /* {{{ */
             if (0 < subtle->views->ndata) {
                 int i, vx = p->x;
-                SubStyle s = {.flags = SUB_TYPE_STYLE, .min = -1, .fg = -1, .bg = -1, .icon = -1,
-                              .top = -1, .right = -1, .bottom = -1, .left = -1,
-                              .border = {-1}, .padding = {-1}, .margin = {-1}};
+                SubStyle *s = NULL;
 
                 /* View buttons */
                 for (i = 0; i < subtle->views->ndata; i++) {
@@ -419,25 +681,24 @@ void subPanelRender(SubPanel *p, Drawable drawable) {
                     SubView *v = VIEW(subtle->views->data[i]);
 
                     /* Skip dynamic views */
-                    if (v->flags & SUB_VIEW_DYNAMIC && !(subtle->client_tags & v->tags))
+                    if (v->flags & SUB_VIEW_DYNAMIC
+                        && !subTagsMatch(&subtle->client_tags, &v->tags))
                         continue;
 
                     /* Select style and calculate x and y offsets */
-                    PanelViewStyle(v, i, (p->screen->viewid == i), &s);
+                    s = PanelViewStyle(v, i, (p->screen->viewid == i));
 
-                    x += STYLE_LEFT((s));
-                    y = STYLE_FONT_Y(s, s.font);
+                    x += STYLE_LEFT((*s));
+                    y = STYLE_FONT_Y((*s), s->font);
 
                     /* Set window background and border*/
-                    PanelDrawRect(drawable, vx, v->width, &s);
+                    PanelDrawRect(drawable, vx, v->width, s);
 
                     /* Draw view icon and/or text */
                     if (v->flags & SUB_VIEW_ICON) {
                         int icony = (subtle->ph - v->icon->height) / 2;
 
-                        subSharedDrawIcon(subtle->dpy, subtle->gcs.draw, drawable, vx + x, icony,
-                                          v->icon->width, v->icon->height, s.icon, s.bg,
-                                          v->icon->pixmap, v->icon->bitmap);
+                        PanelDrawIcon(drawable, vx + x, icony, v->icon, s->icon, s->bg);
                     }
 
                     if (!(v->flags & SUB_VIEW_ICON_ONLY)) {
@@ -446,8 +707,8 @@ void subPanelRender(SubPanel *p, Drawable drawable) {
                             x += v->icon->width + 3;
                         }
 
-                        subSharedDrawString(subtle->dpy, subtle->gcs.draw, s.font, drawable, vx + x,
-                                            y, s.fg, s.bg, v->name, strlen(v->name));
+                        subSharedDrawString(subtle->dpy, subtle->gcs.draw, s->font, drawable, vx + x,
+                                            y, s->fg, s->bg, v->name, strlen(v->name));
                     }
 
                     vx += v->width;
@@ -475,6 +736,131 @@ void subPanelRender(SubPanel *p, Drawable drawable) {
     subSubtleLogDebugSubtle("Render\n");
 } /* }}} */
 
+/** subPanelDamage {{{
+ * @brief Check whether panel changed since it was rendered
+ * @param[in]   p    A #SubPanel
+ * @param[out]  old  Previously drawn extent
+ * @return Returns whether panel needs to be redrawn
+ **/
+
+int subPanelDamage(SubPanel *p, XRectangle *old) {
+    int damaged = False;
+    unsigned long content = 0;
+    XRectangle drawn = {0};
+
+    assert(p && old);
+
+    *old = p->drawn;
+
+    /* Hidden panels don't cover anything */
+    if (!(p->flags & SUB_PANEL_HIDDEN)) {
+        drawn.x = p->x;
+        drawn.width = p->width;
+        drawn.height = subtle->ph;
+
+        /* Add separators around panel */
+        if (subtle->styles.separator.separator) {
+            if (p->flags & SUB_PANEL_SEPARATOR1) {
+                drawn.x -= subtle->styles.separator.separator->width;
+                drawn.width += subtle->styles.separator.separator->width;
+            }
+
+            if (p->flags & SUB_PANEL_SEPARATOR2) {
+                SubStyle *s = p->flags & SUB_PANEL_SUBLET && subtle->styles.sublet_sep
+                                      ? subtle->styles.sublet_sep
+                                      : &subtle->styles.separator;
+
+                drawn.width += s->separator->width;
+            }
+        }
+
+        content = PanelContent(p);
+    }
+
+    damaged = (old->x != drawn.x || old->width != drawn.width || p->content != content);
+
+    p->drawn = drawn;
+    p->content = content;
+
+    return damaged;
+} /* }}} */
+
+/** subPanelAsset {{{
+ * @brief Find cached panel asset or create a new one
+ * @param[in]   key     Asset key
+ * @param[in]   width   Asset width
+ * @param[in]   height  Asset height
+ * @param[in]   source  Icon the asset is drawn from or \p None
+ * @param[out]  pixmap  Asset pixmap
+ * @return Returns whether the asset is new and must be drawn
+ **/
+
+int subPanelAsset(unsigned long key, int width, int height, Pixmap source, Pixmap *pixmap) {
+    int i;
+    PanelAsset *a = NULL;
+
+    assert(pixmap);
+
+    /* Drop assets of old config */
+    if (generation != subtle->generation) {
+        for (i = 0; i < PANEL_ASSETS; i++) {
+            if (assets[i].pixmap) {
+                subSharedDrawForget(subtle->dpy, assets[i].pixmap);
+                XFreePixmap(subtle->dpy, assets[i].pixmap);
+            }
+        }
+
+        memset(assets, 0, sizeof(assets));
+        generation = subtle->generation;
+    }
+
+    key = subSharedHash(key, &width, sizeof(width));
+    key = subSharedHash(key, &height, sizeof(height));
+    a = &assets[key % PANEL_ASSETS];
+
+    /* Hit */
+    if (a->pixmap && a->key == key) {
+        *pixmap = a->pixmap;
+
+        return False;
+    }
+
+    /* Replace slot */
+    if (a->pixmap) {
+        subSharedDrawForget(subtle->dpy, a->pixmap);
+        XFreePixmap(subtle->dpy, a->pixmap);
+    }
+
+    a->key = key;
+    a->source = source;
+    a->pixmap = XCreatePixmap(subtle->dpy, ROOT, width, height,
+                              XDefaultDepth(subtle->dpy, DefaultScreen(subtle->dpy)));
+    *pixmap = a->pixmap;
+
+    subSubtleLogDebugSubtle("Asset: key=%#lx, width=%d, height=%d\n", key, width, height);
+
+    return True;
+} /* }}} */
+
+/** subPanelAssetForget {{{
+ * @brief Drop all cached assets drawn from an icon
+ * @param[in]  source  Icon pixmap
+ **/
+
+void subPanelAssetForget(Pixmap source) {
+    int i;
+
+    /* Icon ids are reused after free */
+    for (i = 0; None != source && i < PANEL_ASSETS; i++) {
+        if (assets[i].pixmap && assets[i].source == source) {
+            subSharedDrawForget(subtle->dpy, assets[i].pixmap);
+            XFreePixmap(subtle->dpy, assets[i].pixmap);
+
+            memset(&assets[i], 0, sizeof(PanelAsset));
+        }
+    }
+} /* }}} */
+
 /** subPanelCompare {{{
  * @brief Compare two panels
  * @param[in]  a  A #SubPanel
@@ -562,7 +948,8 @@ void subPanelAction(SubArray *panels, int type, int x, int y, int button, int bo
                             SubView *v = VIEW(subtle->views->data[j]);
 
                             /* Skip dynamic views */
-                            if (v->flags & SUB_VIEW_DYNAMIC && !(subtle->client_tags & v->tags))
+                            if (v->flags & SUB_VIEW_DYNAMIC
+                                && !subTagsMatch(&subtle->client_tags, &v->tags))
                                 continue;
 
                             /* Check if x is in view rect */
@@ -612,11 +999,17 @@ void subPanelGeometry(SubPanel *p, SubStyle *s, XRectangle *geom) {
 
 void subPanelPublish(void) {
     int i = 0, j = 0, idx = 0;
-    char **sublets = NULL, buf[30] = {0};
+    char **list = NULL, buf[30] = {0};
     XRectangle geom = {0};
 
     /* Alloc space */
-    sublets = (char **) subSharedMemoryAlloc(subtle->sublets->ndata, sizeof(char *));
+    list = (char **) subSharedMemoryAlloc(subtle->sublets->ndata, sizeof(char *));
+    nsublets = 0;
+
+    if (0 < subtle->sublets->ndata) {
+        sublets = (SubPanel **) subSharedMemoryRealloc(sublets, subtle->sublets->ndata *
+                                                                        sizeof(SubPanel *));
+    }
 
     /* We need to publish sublets here, because we cannot rely
      * on the sublets array which is reordered on every update */
@@ -635,26 +1028,38 @@ void subPanelPublish(void) {
                     snprintf(buf, sizeof(buf), "%dx%d+%d+%d#%s", geom.x, geom.y, geom.width,
                              geom.height, p->sublet->name);
 
-                    sublets[idx] = (char *) subSharedMemoryAlloc(strlen(buf) + 1, sizeof(char));
-                    strncpy(sublets[idx++], buf, strlen(buf));
+                    list[idx] = (char *) subSharedMemoryAlloc(strlen(buf) + 1, sizeof(char));
+                    strncpy(list[idx++], buf, strlen(buf));
+
+                    /* Keep ids for client messages */
+                    sublets[nsublets++] = p;
                 }
             }
         }
     }
 
     /* EWMH: Sublet list and geometries */
-    subSharedPropertySetStrings(subtle->dpy, ROOT, subEwmhGet(SUB_EWMH_SUBTLE_SUBLET_LIST), sublets,
-                                subtle->sublets->ndata);
+    subEwmhSetStrings(ROOT, SUB_EWMH_SUBTLE_SUBLET_LIST, list, subtle->sublets->ndata);
 
     /* Tidy up */
     for (i = 0; i < subtle->sublets->ndata; i++)
-        free(sublets[i]);
+        free(list[i]);
 
     subSubtleLogDebugSubtle("Publish: sublets=%d\n", subtle->sublets->ndata);
 
     XSync(subtle->dpy, False); ///< Sync all changes
 
-    free(sublets);
+    free(list);
+} /* }}} */
+
+/** subPanelFind {{{
+ * @brief Find published sublet
+ * @param[in]  id  Sublet id
+ * @return Returns found #SubPanel or \p NULL
+ **/
+
+SubPanel *subPanelFind(int id) {
+    return 0 <= id && id < nsublets ? sublets[id] : NULL;
 } /* }}} */
 
 /** subPanelKill {{{
@@ -667,13 +1072,19 @@ void subPanelKill(SubPanel *p) {
 
     /* Handle panel item type */
     switch (p->flags & (SUB_PANEL_COPY | SUB_PANEL_ICON | SUB_PANEL_KEYCHAIN | SUB_PANEL_SUBLET |
-                        SUB_PANEL_TRAY))
+                        SUB_PANEL_TRAY | SUB_PANEL_VIEWS))
     {
         case SUB_PANEL_COPY:
             break;
+        case SUB_PANEL_VIEWS: /* {{{ */
+            if (p->widths)
+                free(p->widths);
+            break; /* }}} */
         case SUB_PANEL_ICON: /* {{{ */
-            if (p->icon)
+            if (p->icon) {
+                subPanelAssetForget(p->icon->pixmap);
                 free(p->icon);
+            }
             break; /* }}} */
         case SUB_PANEL_KEYCHAIN: /* {{{ */
             if (p->keychain) {
@@ -687,6 +1098,13 @@ void subPanelKill(SubPanel *p) {
             return; /* }}} */
         case SUB_PANEL_SUBLET: /* {{{ */
             if (!(p->flags & SUB_PANEL_COPY)) {
+                /* Drop ids until next publish */
+                if (sublets) {
+                    free(sublets);
+                    sublets = NULL;
+                    nsublets = 0;
+                }
+
                 /* Call unload */
                 if (p->sublet->flags & SUB_SUBLET_UNLOAD) {
                     subRubyCall(SUB_CALL_UNLOAD, p->sublet->instance, NULL);
@@ -715,6 +1133,10 @@ void subPanelKill(SubPanel *p) {
                 if (p->sublet->text) {
                     subTextKill(p->sublet->text);
                 }
+                if (p->sublet->pixmap) {
+                    subSharedDrawForget(subtle->dpy, p->sublet->pixmap);
+                    XFreePixmap(subtle->dpy, p->sublet->pixmap);
+                }
 
                 free(p->sublet);
             }
@@ -722,6 +1144,7 @@ void subPanelKill(SubPanel *p) {
         case SUB_PANEL_TRAY: /* {{{ */
             /* Reparent and return to avoid beeing destroyed */
             XReparentWindow(subtle->dpy, subtle->windows.tray, ROOT, 0, 0);
+            subtle->tray.width = 0; ///< Reset geometry
             p->screen = NULL;
             return; /* }}} */
     }
@@ -99,12 +99,12 @@ static int RubyReceiver(unsigned long instance, unsigned long meth) {
 static SubFont *RubyFont(const char *fontname) {
     SubFont *f = NULL;
 
-    /* Load font */
-    if (!(f = subSharedFontNew(subtle->dpy, fontname))) {
+    /* Load or share font */
+    if (!(f = subStyleFontNew(fontname))) {
         subSubtleLogWarn("Cannot load font `%s'\n", fontname);
 
         /* Load fallback font */
-        if (!(f = subSharedFontNew(subtle->dpy, DEFFONT))) {
+        if (!(f = subStyleFontNew(DEFFONT))) {
             subSubtleLogError("Cannot load fallback font `%s'\n", DEFFONT);
 
             subSubtleFinish();
@@ -118,6 +118,23 @@ static SubFont *RubyFont(const char *fontname) {
 
 /* Type converter */
 
+/* RubyTagsToValue {{{ */
+static VALUE RubyTagsToValue(TAGS *tags) {
+    int i, used = False;
+    VALUE value = INT2FIX(0);
+
+    /* Assemble integer from most significant word down */
+    for (i = TAGSWORDS - 1; 0 <= i; i--) {
+        if (used || 0 != tags->words[i]) {
+            used = True;
+            value = rb_funcall(value, rb_intern("<<"), 1, INT2FIX(32));
+            value = rb_funcall(value, rb_intern("|"), 1, UINT2NUM(tags->words[i]));
+        }
+    }
+
+    return value;
+} /* }}} */
+
 /* RubySubtleToSubtlext {{{ */
 static VALUE RubySubtleToSubtlext(void *data) {
     SubClient *c = NULL;
@@ -147,7 +164,7 @@ static VALUE RubySubtleToSubtlext(void *data) {
             /* Set properties */
             rb_iv_set(object, "@win", LONG2NUM(c->win));
             rb_iv_set(object, "@flags", INT2FIX(flags));
-            rb_iv_set(object, "@tags", INT2FIX(c->tags));
+            rb_iv_set(object, "@tags", RubyTagsToValue(&c->tags));
             rb_iv_set(object, "@name", rb_str_new2(c->name));
             rb_iv_set(object, "@instance", rb_str_new2(c->instance));
             rb_iv_set(object, "@klass", rb_str_new2(c->klass));
@@ -214,7 +231,7 @@ static VALUE RubySubtleToSubtlext(void *data) {
 
             /* Set properties */
             rb_iv_set(object, "@id", INT2FIX(id));
-            rb_iv_set(object, "@tags", INT2FIX(v->tags));
+            rb_iv_set(object, "@tags", RubyTagsToValue(&v->tags));
         } /* }}} */
     }
 
@@ -833,6 +850,7 @@ void RubyEvalPanel(VALUE ary, int position, SubScreen *s) {
                     p = &subtle->panels.tray;
 
                     XReparentWindow(subtle->dpy, subtle->windows.tray, panel, 0, 0);
+                    subtle->tray.width = 0; ///< Reset geometry
                 }
             } else if (entry == views) {
                 /* Create new panel views */
@@ -874,6 +892,7 @@ void RubyEvalPanel(VALUE ary, int position, SubScreen *s) {
                             p->flags |= (p2->flags & (SUB_PANEL_SUBLET | SUB_PANEL_DOWN |
                                                       SUB_PANEL_OVER | SUB_PANEL_OUT));
                             p->sublet = p2->sublet;
+                            p->sublet->flags |= SUB_SUBLET_SHARED;
 
                             printf("Cloned sublet (%s)\n", p->sublet->name);
                         } else {
@@ -1012,8 +1031,8 @@ static void RubyEvalConfig(void) {
     /* Check tag count */
     if (1 == subtle->tags->ndata) {
         subSubtleLogWarn("Cannot find any tags\n");
-    } else if (32 < subtle->tags->ndata) {
-        subSubtleLogWarn("Cannot handle more than 32 tags\n");
+    } else if (TAGSMAX < subtle->tags->ndata) {
+        subSubtleLogWarn("Cannot handle more than %d tags\n", TAGSMAX);
     }
 
     /* Check and update views */
@@ -1027,12 +1046,12 @@ static void RubyEvalConfig(void) {
 
         /* Check for view with default tag */
         for (i = subtle->views->ndata - 1; 0 <= i; i--)
-            if ((v = VIEW(subtle->views->data[i])) && v->tags & DEFAULTTAG) {
+            if ((v = VIEW(subtle->views->data[i])) && subTagsCheck(&v->tags, DEFAULTTAG)) {
                 subSubtleLogDebugRuby("EvalConfig: default view=%s\n", v->name);
                 break;
             }
 
-        v->tags |= DEFAULTTAG; ///< Set default tag
+        subTagsSet(&v->tags, DEFAULTTAG); ///< Set default tag
     }
 
     subViewPublish();
@@ -2756,12 +2775,17 @@ static VALUE RubySubletDataReader(VALUE self) {
         if (0 < p->sublet->text->nitems) {
             /* Concat string */
             for (i = 0; i < p->sublet->text->nitems; i++) {
-                SubTextItem *item = (SubTextItem *) p->sublet->text->items[i];
+                SubTextItem *item = &p->sublet->text->items[i];
+
+                /* Skip icons */
+                if (item->flags & (SUB_TEXT_BITMAP | SUB_TEXT_PIXMAP)) {
+                    continue;
+                }
 
                 if (Qnil == string) {
-                    rb_str_new2(item->data.string);
+                    string = rb_str_new(item->data.string, item->len);
                 } else {
-                    rb_str_cat(string, item->data.string, strlen(item->data.string));
+                    rb_str_cat(string, item->data.string, item->len);
                 }
             }
         }
@@ -2806,6 +2830,93 @@ static VALUE RubySubletDataWriter(VALUE self, VALUE value) {
     return Qnil;
 } /* }}} */
 
+/* RubySubletTemplateWriter {{{ */
+/*
+ * call-seq: template=(string) -> nil
+ *
+ * Set template of Sublet with numbered slots, static parts are measured
+ * only once
+ *
+ *  sublet.template = "^#ff0000^CPU: ^$1^%"
+ *  => nil
+ */
+
+static VALUE RubySubletTemplateWriter(VALUE self, VALUE value) {
+    SubPanel *p = NULL;
+
+    Data_Get_Struct(self, SubPanel, p);
+    if (p) {
+        /* Check value type */
+        if (T_STRING == rb_type(value)) {
+            SubStyle *s = &subtle->styles.sublets, *style = NULL;
+
+            /* Select style */
+            if (s->styles && (style = subArrayGet(s->styles, p->sublet->styleid))) {
+                s = style;
+            }
+
+            p->sublet->width = subTextTemplate(p->sublet->text, subtle->styles.sublets.font,
+                                               RSTRING_PTR(value)) +
+                               STYLE_WIDTH((*s));
+        } else {
+            rb_raise(rb_eArgError, "Unexpected value type for template `%s'",
+                     rb_obj_classname(value));
+        }
+    }
+
+    return Qnil;
+} /* }}} */
+
+/* RubySubletSlotsWriter {{{ */
+/*
+ * call-seq: slots=(array) -> nil
+ *
+ * Set slot values of Sublet template, up to 16 slots
+ *
+ *  sublet.slots = [ 42 ]
+ *  => nil
+ */
+
+static VALUE RubySubletSlotsWriter(VALUE self, VALUE value) {
+    SubPanel *p = NULL;
+
+    Data_Get_Struct(self, SubPanel, p);
+    if (p) {
+        int i, lens[16] = {0}, nvalues = 0;
+        char *values[16] = {NULL};
+        VALUE strings = rb_ary_new();
+        SubStyle *s = &subtle->styles.sublets, *style = NULL;
+
+        /* Allow single values */
+        if (T_ARRAY != rb_type(value)) {
+            value = rb_ary_new3(1, value);
+        }
+
+        nvalues = MIN(RARRAY_LEN(value), LENGTH(values));
+
+        /* Convert values to strings */
+        for (i = 0; i < nvalues; i++) {
+            VALUE str = rb_obj_as_string(rb_ary_entry(value, i));
+
+            rb_ary_push(strings, str); ///< Protect from GC
+
+            values[i] = RSTRING_PTR(str);
+            lens[i] = RSTRING_LEN(str);
+        }
+
+        /* Select style */
+        if (s->styles && (style = subArrayGet(s->styles, p->sublet->styleid))) {
+            s = style;
+        }
+
+        p->sublet->width = subTextSlots(p->sublet->text, subtle->styles.sublets.font, values,
+                                        lens, nvalues) +
+                           STYLE_WIDTH((*s));
+    }
+
+    return Qnil;
+} /* }}} */
+
 /* RubySubletGeometryReader {{{ */
 /*
  * call-seq: geometry -> Subtlext::Geometry
@@ -3222,6 +3333,8 @@ void subRubyInit(void) {
     rb_define_method(sublet, "interval=", RubySubletIntervalWriter, 1);
     rb_define_method(sublet, "data", RubySubletDataReader, 0);
     rb_define_method(sublet, "data=", RubySubletDataWriter, 1);
+    rb_define_method(sublet, "template=", RubySubletTemplateWriter, 1);
+    rb_define_method(sublet, "slots=", RubySubletSlotsWriter, 1);
     rb_define_method(sublet, "geometry", RubySubletGeometryReader, 0);
     rb_define_method(sublet, "screen", RubySubletScreenReader, 0);
     rb_define_method(sublet, "show", RubySubletShow, 0);
@@ -3316,6 +3429,9 @@ void subRubyReloadConfig(void) {
     /* Reset panel height */
     subtle->ph = 0;
 
+    /* Invalidate everything measured with the old config */
+    subtle->generation++;
+
     /* Reset flags before reloading */
     subtle->flags &= (SUB_SUBTLE_DEBUG | SUB_SUBTLE_EWMH | SUB_SUBTLE_RUN | SUB_SUBTLE_XINERAMA |
                       SUB_SUBTLE_XRANDR | SUB_SUBTLE_URGENT);
@@ -3331,6 +3447,7 @@ void subRubyReloadConfig(void) {
 
         p->flags &= ~(SUB_PANEL_BOTTOM | SUB_PANEL_SPACER1 | SUB_PANEL_SPACER1 |
                       SUB_PANEL_SEPARATOR1 | SUB_PANEL_SEPARATOR2);
+        p->sublet->flags &= ~SUB_SUBLET_SHARED;
         p->screen = NULL;
     }
 
@@ -3343,6 +3460,7 @@ void subRubyReloadConfig(void) {
 
         vids[i] = s->viewid; ///< Store views
         s->flags &= ~(SUB_SCREEN_STIPPLE | SUB_SCREEN_PANEL1 | SUB_SCREEN_PANEL2);
+        s->flags |= SUB_SCREEN_DAMAGE; ///< Styles may change
 
         subArrayClear(s->panels, True);
     }
@@ -3357,6 +3475,7 @@ void subRubyReloadConfig(void) {
 
     /* Load and configure */
     subRubyLoadConfig();
+    subStyleFontFlush(); ///< Free fonts of the old config
     subRubyLoadSublets();
     subRubyLoadPanels();
     subDisplayConfigure();
@@ -3384,6 +3503,16 @@ void subRubyReloadConfig(void) {
 
     printf("Reloaded config\n");
 
+#ifdef DEBUG
+    {
+        unsigned long nhits = 0, nmisses = 0;
+
+        subSharedStringWidthStats(&nhits, &nmisses);
+
+        subSubtleLogDebugSubtle("Reload: width cache hits=%lu, misses=%lu\n", nhits, nmisses);
+    }
+#endif /* DEBUG */
+
     /* Update screens and panels */
     subScreenConfigure();
     subScreenUpdate();
@@ -3602,6 +3731,9 @@ int subRubyCall(int type, unsigned long proc, void *data) {
     int state = 0;
     VALUE rargs[3] = {Qnil};
 
+    /* Scripts may read root properties */
+    subEwmhFlush();
+
     /* Wrap up data */
     rargs[0] = (VALUE) type;
     rargs[1] = proc;
@@ -12,6 +12,12 @@
 
 #include "subtle.h"
 
+#ifdef DEBUG
+#include <sys/time.h>
+#endif /* DEBUG */
+
+#define SCREEN_SPANS 8 ///< Max damaged spans per panel
+
 /* ScreenPublish {{{ */
 static void ScreenPublish(void) {
     int i;
@@ -57,22 +63,92 @@ static void ScreenPublish(void) {
 } /* }}} */
 
 /* ScreenClear {{{ */
-static void ScreenClear(SubScreen *s, SubStyle *style) {
-    /* Clear pixmap */
-    XSetForeground(subtle->dpy, subtle->gcs.draw, style->bg);
-    XFillRectangle(subtle->dpy, s->drawable, subtle->gcs.draw, 0, 0, s->base.width, subtle->ph);
+static void ScreenClear(SubScreen *s, SubStyle *style, int x, int width) {
+    int stipple = (s->flags & SUB_SCREEN_STIPPLE);
+    unsigned long key = 0;
+    Pixmap pixmap = None;
+
+    key = subSharedHash(0, "background", 10);
+    key = subSharedHash(key, &style->fg, 3 * sizeof(long)); ///< Fg, bg and stipple
+    key = subSharedHash(key, &stipple, sizeof(stipple));
+
+    /* Render background once */
+    if (subPanelAsset(key, s->base.width, subtle->ph, None, &pixmap)) {
+        XSetForeground(subtle->dpy, subtle->gcs.draw, style->bg);
+        XFillRectangle(subtle->dpy, pixmap, subtle->gcs.draw, 0, 0, s->base.width, subtle->ph);
+
+        /* Draw stipple on panels */
+        if (stipple) {
+            XGCValues gvals;
+
+            gvals.stipple = style->icon;
+            gvals.foreground = style->fg;
+            XChangeGC(subtle->dpy, subtle->gcs.stipple, GCForeground | GCStipple, &gvals);
+
+            XFillRectangle(subtle->dpy, pixmap, subtle->gcs.stipple, 0, 0, s->base.width,
+                           subtle->ph);
+        }
+    }
+
+    XCopyArea(subtle->dpy, pixmap, s->drawable, subtle->gcs.draw, x, 0, width, subtle->ph, x, 0);
+} /* }}} */
+
+/* ScreenDamage {{{ */
+static void ScreenDamage(XRectangle *spans, int *nspans, int x, int width) {
+    int i;
+
+    /* Clip to panel */
+    if (0 > x) {
+        width += x;
+        x = 0;
+    }
+
+    if (0 >= width) {
+        return;
+    }
 
-    /* Draw stipple on panels */
-    if (s->flags & SUB_SCREEN_STIPPLE) {
-        XGCValues gvals;
+    /* Merge with touching spans or fold everything into one when full */
+    for (i = 0; i < *nspans; i++) {
+        int right = spans[i].x + spans[i].width;
 
-        gvals.stipple = style->icon;
-        gvals.foreground = style->fg;
-        XChangeGC(subtle->dpy, subtle->gcs.stipple, GCForeground | GCStipple, &gvals);
+        if ((x <= right && spans[i].x <= x + width) || SCREEN_SPANS == *nspans) {
+            width = MAX(x + width, right);
+            x = MIN(x, spans[i].x);
+            width -= x;
+
+            spans[i--] = spans[--(*nspans)]; ///< Remove and check again
+        }
+    }
+
+    spans[*nspans].x = x;
+    spans[*nspans].y = 0;
+    spans[*nspans].width = width;
+    spans[*nspans].height = subtle->ph;
+
+    (*nspans)++;
+} /* }}} */
 
-        XFillRectangle(subtle->dpy, s->drawable, subtle->gcs.stipple, 0, 0, s->base.width,
-                       subtle->ph);
+/* ScreenLayout {{{ */
+static unsigned long ScreenLayout(SubScreen *s) {
+    int i;
+    unsigned long hash = 0;
+
+    /* Hash everything panel positions depend on */
+    for (i = 0; s->panels && i < s->panels->ndata; i++) {
+        SubPanel *p = PANEL(s->panels->data[i]);
+        FLAGS flags = p->flags & (SUB_PANEL_HIDDEN | SUB_PANEL_BOTTOM | SUB_PANEL_CENTER |
+                                  SUB_PANEL_SPACER1 | SUB_PANEL_SPACER2 |
+                                  SUB_PANEL_SEPARATOR1 | SUB_PANEL_SEPARATOR2);
+
+        hash = subSharedHash(hash, &p->x, sizeof(p->x));
+        hash = subSharedHash(hash, &p->width, sizeof(p->width));
+        hash = subSharedHash(hash, &flags, sizeof(flags));
     }
+
+    hash = subSharedHash(hash, &s->base, sizeof(s->base));
+    hash = subSharedHash(hash, &subtle->generation, sizeof(subtle->generation));
+
+    return hash;
 } /* }}} */
 
 /* Public */
@@ -172,6 +248,8 @@ SubScreen *subScreenNew(int x, int y, unsigned int width, unsigned int height) {
     s->geom.height = height;
     s->base = s->geom; ///< Backup size
 
+    subtle->spatial.stale = True; ///< Index new screen
+
     /* Create panel windows */
     sattrs.event_mask = ButtonPressMask | EnterWindowMask | LeaveWindowMask | ExposureMask;
     sattrs.override_redirect = True;
@@ -264,44 +342,58 @@ SubScreen *subScreenCurrent(int *sid) {
 
 void subScreenConfigure(void) {
     int i;
+    TAGS visible_tags;
     SubScreen *s = NULL;
     SubView *v = NULL;
 
     /* Reset visible tags, views and available clients */
-    subtle->visible_tags = 0;
-    subtle->visible_views = 0;
-    subtle->client_tags = 0;
+    visible_tags = subtle->visible_tags;
+    memset(&subtle->visible_tags, 0, sizeof(TAGS));
+    memset(&subtle->visible_views, 0, sizeof(TAGS));
+    memset(&subtle->client_tags, 0, sizeof(TAGS));
+
+    /* Check views of each screen */
+    for (i = 0; i < subtle->screens->ndata; i++) {
+        s = SCREEN(subtle->screens->data[i]);
+        v = VIEW(subtle->views->data[s->viewid]);
+
+        /* Set visible tags and views to ease lookups */
+        subTagsAdd(&subtle->visible_tags, &v->tags);
+        subTagsSet(&subtle->visible_views, s->viewid);
+    }
 
     /* Either check each client or just get visible clients */
-    if (0 < subtle->clients->ndata) {
+    if (0 < subtle->hot.nentries) {
         int j;
 
-        /* Check each client */
-        for (i = 0; i < subtle->clients->ndata; i++) {
-            SubClient *c = CLIENT(subtle->clients->data[i]);
+        /* Check each client in its hot state slot */
+        for (i = 0; i < subtle->hot.nentries; i++) {
+            SubClient *c = NULL;
+            FLAGS flags = subtle->hot.flags[i];
+            TAGS *tags = &subtle->hot.tags[i];
             int gravityid = 0, screenid = 0, viewid = 0, visible = 0;
 
             /* Ignore dead or just iconified clients */
-            if (c->flags & SUB_CLIENT_DEAD) {
+            if (flags & SUB_CLIENT_DEAD) {
                 continue;
             }
 
             /* Set available client tags to ease lookups */
-            subtle->client_tags |= c->tags;
+            subTagsAdd(&subtle->client_tags, tags);
+
+            c = subtle->hot.clients[i];
 
             /* Check view of each screen */
             for (j = 0; j < subtle->screens->ndata; j++) {
                 s = SCREEN(subtle->screens->data[j]);
                 v = VIEW(subtle->views->data[s->viewid]);
 
-                /* Set visible tags and views to ease lookups */
-                subtle->visible_tags |= v->tags;
-                subtle->visible_views |= (1L << (s->viewid + 1));
-
                 /* Find visible clients */
-                if (VISIBLETAGS(c, v->tags)) {
+                if (subTagsMatch(tags, &v->tags)
+                    || flags & (SUB_CLIENT_TYPE_DESKTOP | SUB_CLIENT_MODE_STICK))
+                {
                     /* Keep screen when sticky */
-                    if (c->flags & SUB_CLIENT_MODE_STICK) {
+                    if (flags & SUB_CLIENT_MODE_STICK) {
                         /* Keep gravity from sticky screen/view and not the one
                          * of the current screen/view in loop */
                         s = SCREEN(subtle->screens->data[c->screenid]);
@@ -335,25 +427,23 @@ void subScreenConfigure(void) {
                 subEwmhSetCardinals(c->win, SUB_EWMH_SUBTLE_CLIENT_SCREEN, (long *) &screenid, 1);
             } else { ///< Unmap other windows
                 c->flags |= SUB_CLIENT_UNMAP; ///< Ignore next unmap
+                subClientHotStore(c);
                 subEwmhSetWMState(c->win, WithdrawnState);
                 XUnmapWindow(subtle->dpy, c->win);
             }
         }
-    } else {
-        /* Check views of each screen */
-        for (i = 0; i < subtle->screens->ndata; i++) {
-            s = SCREEN(subtle->screens->data[i]);
-            v = VIEW(subtle->views->data[s->viewid]);
-
-            /* Set visible tags and views to ease lookups */
-            subtle->visible_tags |= v->tags;
-            subtle->visible_views |= (1L << (s->viewid + 1));
-        }
+    }
+
+    /* Spatial index only depends on visible tags here */
+    if (0 != memcmp(&visible_tags, &subtle->visible_tags, sizeof(TAGS))) {
+        subtle->spatial.stale = True;
     }
 
     /* EWMH: Visible tags, views */
-    subEwmhSetCardinals(ROOT, SUB_EWMH_SUBTLE_VISIBLE_TAGS, (long *) &subtle->visible_tags, 1);
-    subEwmhSetCardinals(ROOT, SUB_EWMH_SUBTLE_VISIBLE_VIEWS, (long *) &subtle->visible_views, 1);
+    subEwmhSetTags(ROOT, SUB_EWMH_SUBTLE_VISIBLE_TAGS, &subtle->visible_tags,
+                   TAGSUSED(subtle->tags->ndata));
+    subEwmhSetTags(ROOT, SUB_EWMH_SUBTLE_VISIBLE_VIEWS, &subtle->visible_views,
+                   TAGSUSED(subtle->views->ndata));
 
     XSync(subtle->dpy, False); ///< Sync before going on
 
@@ -378,12 +468,19 @@ void subScreenUpdate(void) {
         int x[4] = {0}, nspacer[4] = {0}; ///< Waste ints but it's easier for the algo
         int sw[4] = {0}, fix[4] = {0}, width[4] = {0}, spacer[4] = {0};
 
+        /* Update panels and skip layout when nothing changed */
+        for (j = 0; s->panels && j < s->panels->ndata; j++) {
+            subPanelUpdate(PANEL(s->panels->data[j]));
+        }
+
+        if (ScreenLayout(s) == s->layout) {
+            continue;
+        }
+
         /* Pass 1: Collect width for spacer sizes */
         for (j = 0; s->panels && j < s->panels->ndata; j++) {
             p = PANEL(s->panels->data[j]);
 
-            subPanelUpdate(p);
-
             /* Check flags */
             if (p->flags & SUB_PANEL_HIDDEN) {
                 continue;
@@ -470,18 +567,27 @@ void subScreenUpdate(void) {
             /* Set panel position */
             if (p->flags & SUB_PANEL_TRAY) {
                 if (0 < subtle->trays->ndata) {
-                    int tray_width = p->width - STYLE_WIDTH(subtle->styles.tray);
-                    int tray_height = subtle->ph - STYLE_HEIGHT(subtle->styles.tray);
+                    XRectangle geom = {0};
 
-                    XMapRaised(subtle->dpy, subtle->windows.tray);
+                    geom.x = x[offset] + STYLE_LEFT(subtle->styles.tray);
+                    geom.y = STYLE_TOP(subtle->styles.tray);
+                    geom.width = p->width - STYLE_WIDTH(subtle->styles.tray);
+                    geom.height = subtle->ph - STYLE_HEIGHT(subtle->styles.tray);
+
+                    /* Map once and move only when the geometry changed; the
+                     * window background already is the tray style color */
+                    if (0 == subtle->tray.width) {
+                        XMapRaised(subtle->dpy, subtle->windows.tray);
+                    }
 
-                    XSetForeground(subtle->dpy, subtle->gcs.draw, subtle->styles.tray.bg);
-                    XFillRectangle(subtle->dpy, subtle->windows.tray, subtle->gcs.draw, 0, 0,
-                                   tray_width, tray_height);
+                    if (subtle->tray.x != geom.x || subtle->tray.y != geom.y
+                        || subtle->tray.width != geom.width || subtle->tray.height != geom.height)
+                    {
+                        XMoveResizeWindow(subtle->dpy, subtle->windows.tray, geom.x, geom.y,
+                                          geom.width, geom.height);
 
-                    XMoveResizeWindow(subtle->dpy, subtle->windows.tray,
-                                      x[offset] + STYLE_LEFT(subtle->styles.tray),
-                                      STYLE_TOP(subtle->styles.tray), tray_width, tray_height);
+                        subtle->tray = geom;
+                    }
                 }
             }
 
@@ -504,50 +610,120 @@ void subScreenUpdate(void) {
 
             x[offset] += p->width;
         }
+
+        s->layout = ScreenLayout(s);
     }
 
     subSubtleLogDebugSubtle("Update\n");
 } /* }}} */
 
 /** subScreenRender {{{
- * @brief Render screens
+ * @brief Schedule render of screens for the next cycle
  **/
 
 void subScreenRender(void) {
-    int i, j;
+    subtle->flags |= SUB_SUBTLE_RENDER;
+} /* }}} */
+
+/** subScreenFlush {{{
+ * @brief Render screens once when scheduled
+ **/
+
+void subScreenFlush(void) {
+    int i, j, k, l, nspans[2], total = 0, pixels = 0;
+    XRectangle spans[2][SCREEN_SPANS], old;
+#ifdef DEBUG
+    unsigned long requests = XNextRequest(subtle->dpy);
+    struct timeval start, end;
+#endif /* DEBUG */
+
+    if (!(subtle->flags & SUB_SUBTLE_RENDER)) {
+        return;
+    }
+
+    subtle->flags &= ~SUB_SUBTLE_RENDER;
+
+#ifdef DEBUG
+    gettimeofday(&start, NULL);
+#endif /* DEBUG */
 
     /* Render all screens */
     for (i = 0; i < subtle->screens->ndata; i++) {
         SubScreen *s = SCREEN(subtle->screens->data[i]);
-        Window panel = s->panel1;
+        Window panels[2] = {s->panel1, s->panel2};
+        SubStyle *styles[2] = {&subtle->styles.panel_top, &subtle->styles.panel_bot};
 
-        ScreenClear(s, &subtle->styles.panel_top);
+        nspans[0] = nspans[1] = 0;
 
-        /* Render panel items */
+        /* Collect old and new extents of changed panel items */
         for (j = 0; s->panels && j < s->panels->ndata; j++) {
             SubPanel *p = PANEL(s->panels->data[j]);
 
-            if (p->flags & SUB_PANEL_HIDDEN) {
+            k = (p->flags & SUB_PANEL_BOTTOM) ? 1 : 0;
+
+            if (subPanelDamage(p, &old)) {
+                ScreenDamage(spans[k], &nspans[k], old.x, old.width);
+                ScreenDamage(spans[k], &nspans[k], p->drawn.x, p->drawn.width);
+            }
+        }
+
+        /* Repaint everything on expose, resize or reload */
+        if (s->flags & SUB_SCREEN_DAMAGE) {
+            nspans[0] = nspans[1] = 0;
+
+            ScreenDamage(spans[0], &nspans[0], 0, s->base.width);
+            ScreenDamage(spans[1], &nspans[1], 0, s->base.width);
+
+            s->flags &= ~SUB_SCREEN_DAMAGE;
+        }
+
+        /* Redraw damaged spans and copy only these */
+        for (k = 0; k < 2; k++) {
+            /* Skip disabled panels, nothing shows there */
+            if (!(s->flags & (0 == k ? SUB_SCREEN_PANEL1 : SUB_SCREEN_PANEL2))) {
                 continue;
             }
-            if (panel != s->panel2 && p->flags & SUB_PANEL_BOTTOM) {
-                XCopyArea(subtle->dpy, s->drawable, panel, subtle->gcs.draw, 0, 0, s->base.width,
-                          subtle->ph, 0, 0);
 
-                ScreenClear(s, &subtle->styles.panel_bot);
-                panel = s->panel2;
+            for (l = 0; l < nspans[k]; l++) {
+                XRectangle *r = &spans[k][l];
+
+                ScreenClear(s, styles[k], r->x, r->width);
+
+                for (j = 0; s->panels && j < s->panels->ndata; j++) {
+                    SubPanel *p = PANEL(s->panels->data[j]);
+
+                    if (p->flags & SUB_PANEL_HIDDEN || k != ((p->flags & SUB_PANEL_BOTTOM) ? 1 : 0)
+                        || p->drawn.x >= r->x + r->width || r->x >= p->drawn.x + p->drawn.width)
+                    {
+                        continue;
+                    }
+
+                    subPanelRender(p, s->drawable);
+                }
+
+                XCopyArea(subtle->dpy, s->drawable, panels[k], subtle->gcs.draw, r->x, 0,
+                          r->width, subtle->ph, r->x, 0);
+
+                pixels += r->width;
             }
 
-            subPanelRender(p, s->drawable);
+            total += nspans[k];
         }
+    }
 
-        XCopyArea(subtle->dpy, s->drawable, panel, subtle->gcs.draw, 0, 0, s->base.width,
-                  subtle->ph, 0, 0);
+    /* Just push requests, waiting for the reply costs a round trip */
+    if (0 < total) {
+        XFlush(subtle->dpy);
     }
 
-    XSync(subtle->dpy, False); ///< Sync before going on
+#ifdef DEBUG
+    gettimeofday(&end, NULL);
 
-    subSubtleLogDebugSubtle("Render\n");
+    /* Read by test/bench/panelrender.rb */
+    subSubtleLogDebugSubtle("Render: spans=%d, pixels=%d, requests=%lu, usecs=%ld\n", total,
+                            pixels, XNextRequest(subtle->dpy) - requests,
+                            (end.tv_sec - start.tv_sec) * 1000000L + end.tv_usec - start.tv_usec);
+#endif /* DEBUG */
 } /* }}} */
 
 /** subScreenResize {{{
@@ -597,10 +773,12 @@ void subScreenResize(void) {
 
         /* Create/update drawable for double buffering */
         if (s->drawable) {
+            subSharedDrawForget(subtle->dpy, s->drawable);
             XFreePixmap(subtle->dpy, s->drawable);
         }
         s->drawable = XCreatePixmap(subtle->dpy, ROOT, s->base.width, subtle->ph,
                                     XDefaultDepth(subtle->dpy, DefaultScreen(subtle->dpy)));
+        s->flags |= SUB_SCREEN_DAMAGE;
     }
 
     ScreenPublish();
@@ -647,9 +825,16 @@ void subScreenKill(SubScreen *s) {
 
     /* Destroy drawable */
     if (s->drawable) {
+        subSharedDrawForget(subtle->dpy, s->drawable);
         XFreePixmap(subtle->dpy, s->drawable);
     }
 
+    /* Free spatial index */
+    if (s->byx) {
+        free(s->byx);
+        free(s->byy);
+    }
+
     free(s);
 
     subSubtleLogDebugSubtle("Kill\n");
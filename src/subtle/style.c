@@ -12,6 +12,17 @@
 
 #include "subtle.h"
 
+/* Typedefs {{{ */
+typedef struct stylefont_t {
+    char *name; ///< Style font name
+    SubFont *font; ///< Style font
+    int refs; ///< Style font references
+} StyleFontRef;
+/* }}} */
+
+static StyleFontRef *fonts = NULL;
+static int nfonts = 0;
+
 /* StyleInheritSides {{{ */
 static void StyleInheritSides(SubSides *s1, SubSides *s2, int merge) {
     if (-1 == s1->top || (merge && -1 != s2->top)) {
@@ -112,6 +123,13 @@ static void StyleInherit(SubStyle *s1, SubStyle *s2) {
     }
 } /* }}} */
 
+/* StyleKey {{{ */
+static unsigned long StyleKey(void *elem) {
+    SubStyle *s = STYLE(elem);
+
+    return s->name ? subSharedHash(0, s->name, strlen(s->name)) : 0;
+} /* }}} */
+
 /* StyleFont {{{ */
 static void StyleFont(SubStyle *s, const char *name) {
     /* Check if style exists and font is defined */
@@ -122,6 +140,66 @@ static void StyleFont(SubStyle *s, const char *name) {
     }
 } /* }}} */
 
+/* StyleResolve {{{ */
+static void StyleResolve(SubStyle *s, SubStyle *base, int state) {
+    s->flags = SUB_TYPE_STYLE;
+    s->min = -1;
+
+    /* Select style like for views without any states */
+    if (subtle->styles.views.styles) {
+        subStyleReset(s, -1);
+
+        /* Pick base style */
+        if (!base) {
+            if (subtle->styles.focus && state & SUB_STYLE_STATE_FOCUS) {
+                base = subtle->styles.focus;
+            } else if (subtle->styles.occupied && state & SUB_STYLE_STATE_OCCUPIED) {
+                base = subtle->styles.occupied;
+            }
+        }
+
+        /* Merge base style or default */
+        subStyleMerge(s, !base ? &subtle->styles.views : base);
+
+        /* Apply modifiers */
+        if (subtle->styles.urgent && state & SUB_STYLE_STATE_URGENT) {
+            subStyleMerge(s, subtle->styles.urgent);
+        }
+        if (subtle->styles.visible && state & SUB_STYLE_STATE_VISIBLE) {
+            subStyleMerge(s, subtle->styles.visible);
+        }
+    } else {
+        s->fg = s->bg = s->icon = s->top = s->right = s->bottom = s->left = -1;
+        s->border.top = s->padding.top = s->margin.top = -1;
+
+        subStyleMerge(s, &subtle->styles.views);
+    }
+} /* }}} */
+
+/* StyleTable {{{ */
+static void StyleTable(void) {
+    int i, j;
+
+    /* Row 0 is for views without own style */
+    subtle->styles.ntable = 1 + (subtle->styles.views.styles ?
+                                 subtle->styles.views.styles->ndata : 0);
+
+    if (subtle->styles.table) {
+        free(subtle->styles.table);
+    }
+
+    subtle->styles.table = (SubStyle *) subSharedMemoryAlloc(
+            subtle->styles.ntable * SUB_STYLE_STATES, sizeof(SubStyle));
+
+    for (i = 0; i < subtle->styles.ntable; i++) {
+        SubStyle *base = 0 < i ? STYLE(subtle->styles.views.styles->data[i - 1]) : NULL;
+
+        for (j = 0; j < SUB_STYLE_STATES; j++) {
+            StyleResolve(&subtle->styles.table[i * SUB_STYLE_STATES + j], base, j);
+        }
+    }
+} /* }}} */
+
 /* Public */
 
 /** subStyleNew {{{
@@ -158,14 +236,19 @@ SubStyle *subStyleFind(SubStyle *s, char *name, int *idx) {
     assert(s);
 
     if (s->styles && name) {
-        int i;
+        int i, pos = 0;
+        unsigned long key = subSharedHash(0, name, strlen(name));
 
-        /* Check each state */
-        for (i = 0; i < s->styles->ndata; i++) {
+        if (!s->index) {
+            s->index = subIndexNew(s->styles, StyleKey);
+        }
+
+        /* Check states with same key */
+        while (-1 != (i = subIndexFind(s->index, key, &pos))) {
             SubStyle *style = STYLE(s->styles->data[i]);
 
             /* Compare state name */
-            if (0 == strcmp(name, style->name)) {
+            if (style->name && 0 == strcmp(name, style->name)) {
                 found = style;
                 if (idx) {
                     *idx = i;
@@ -200,7 +283,7 @@ void subStyleReset(SubStyle *s, int val) {
 
     /* Reset font */
     if (s->flags & SUB_STYLE_FONT && s->font) {
-        subSharedFontKill(subtle->dpy, s->font);
+        subStyleFontKill(s->font);
         s->flags &= ~SUB_STYLE_FONT;
     }
 
@@ -220,6 +303,9 @@ void subStyleReset(SubStyle *s, int val) {
     }
     s->styles = NULL;
 
+    subIndexKill(s->index);
+    s->index = NULL;
+
     subSubtleLogDebugSubtle("Reset\n");
 } /* }}} */
 
@@ -276,9 +362,9 @@ void subStyleMerge(SubStyle *s1, SubStyle *s2) {
 void subStyleKill(SubStyle *s) {
     assert(s);
 
-    /* Free font */
+    /* Release font */
     if (s->flags & SUB_STYLE_FONT && s->font) {
-        subSharedFontKill(subtle->dpy, s->font);
+        subStyleFontKill(s->font);
     }
 
     /* Free separator */
@@ -293,6 +379,7 @@ void subStyleKill(SubStyle *s) {
     if (s->styles) {
         subArrayKill(s->styles, True);
     }
+    subIndexKill(s->index);
     free(s);
 
     subSubtleLogDebugSubtle("Kill\n");
@@ -300,6 +387,95 @@ void subStyleKill(SubStyle *s) {
 
 /* All */
 
+/** subStyleFontNew {{{
+ * @brief Get font from cache or load it
+ * @param[in]  name  Font name
+ * @return Returns a shared #SubFont or \p NULL
+ **/
+
+SubFont *subStyleFontNew(const char *name) {
+    int i;
+    SubFont *f = NULL;
+
+    assert(name);
+
+    /* Check cache */
+    for (i = 0; i < nfonts; i++) {
+        if (0 == strcmp(fonts[i].name, name)) {
+            fonts[i].refs++;
+
+            subSubtleLogDebugSubtle("FontNew: cached, name=%s, refs=%d\n", name, fonts[i].refs);
+
+            return fonts[i].font;
+        }
+    }
+
+    /* Load font */
+    if ((f = subSharedFontNew(subtle->dpy, name))) {
+        fonts = (StyleFontRef *) subSharedMemoryRealloc(fonts, (nfonts + 1) * sizeof(StyleFontRef));
+
+        fonts[nfonts].name = strdup(name);
+        fonts[nfonts].font = f;
+        fonts[nfonts].refs = 1;
+        nfonts++;
+
+        subSubtleLogDebugSubtle("FontNew: loaded, name=%s\n", name);
+    }
+
+    return f;
+} /* }}} */
+
+/** subStyleFontKill {{{
+ * @brief Release font reference
+ * @param[in]  f  A #SubFont
+ **/
+
+void subStyleFontKill(SubFont *f) {
+    int i;
+
+    assert(f);
+
+    /* Fonts are freed on flush, so reload can reuse them */
+    for (i = 0; i < nfonts; i++) {
+        if (fonts[i].font == f) {
+            if (0 < fonts[i].refs) {
+                fonts[i].refs--;
+            }
+
+            break;
+        }
+    }
+
+    subSubtleLogDebugSubtle("FontKill\n");
+} /* }}} */
+
+/** subStyleFontFlush {{{
+ * @brief Free fonts without references
+ **/
+
+void subStyleFontFlush(void) {
+    int i, j;
+
+    for (i = 0, j = 0; i < nfonts; i++) {
+        if (0 == fonts[i].refs) {
+            subSubtleLogDebugSubtle("FontFlush: name=%s\n", fonts[i].name);
+
+            subSharedFontKill(subtle->dpy, fonts[i].font);
+            free(fonts[i].name);
+        } else {
+            fonts[j++] = fonts[i];
+        }
+    }
+
+    nfonts = j;
+
+    /* Free cache */
+    if (0 == nfonts && fonts) {
+        free(fonts);
+        fonts = NULL;
+    }
+} /* }}} */
+
 /** subStyleUpdate {{{
  * Inherit style values from all
  **/
@@ -323,7 +499,30 @@ void subStyleUpdate(void) {
     StyleFont(subtle->styles.view_sep, "view separator");
     StyleFont(subtle->styles.sublet_sep, "sublet separator");
 
+    /* Resolve view styles once */
+    StyleTable();
+
     subSubtleLogDebugSubtle("Update\n");
 } /* }}} */
 
+/** subStyleView {{{
+ * @brief Get resolved view style
+ * @param[in]  styleid  View style id or \p -1
+ * @param[in]  state    View state mask
+ * @return Returns the effective #SubStyle
+ **/
+
+SubStyle *subStyleView(int styleid, int state) {
+    int row = 0;
+
+    assert(subtle->styles.table);
+
+    /* Views with unknown styles use the default row */
+    if (0 <= styleid && styleid < subtle->styles.ntable - 1) {
+        row = styleid + 1;
+    }
+
+    return &subtle->styles.table[row * SUB_STYLE_STATES + (state & (SUB_STYLE_STATES - 1))];
+} /* }}} */
+
 // vim:ts=2:bs=2:sw=2:et:fdm=marker
@@ -255,6 +255,28 @@ void subSubtleFinish(void) {
             subArrayKill(subtle->hooks, False);
         }
 
+        /* Kill indices */
+        subIndexKill(subtle->indices.gravities);
+        subIndexKill(subtle->indices.tags);
+        subIndexKill(subtle->indices.views);
+
+        /* Free hot client state */
+        if (subtle->hot.size) {
+            free(subtle->hot.clients);
+            free(subtle->hot.flags);
+            free(subtle->hot.tags);
+            free(subtle->hot.screenids);
+            free(subtle->hot.gravityids);
+        }
+
+        if (subtle->list.wins) {
+            free(subtle->list.wins);
+        }
+
+        if (subtle->history.screens) {
+            free(subtle->history.screens);
+        }
+
         /* Reset styles to free fonts and substyles */
         subStyleReset(&subtle->styles.all, 0);
         subStyleReset(&subtle->styles.views, 0);
@@ -265,6 +287,11 @@ void subSubtleFinish(void) {
         subStyleReset(&subtle->styles.panel_top, 0);
         subStyleReset(&subtle->styles.panel_bot, 0);
         subStyleReset(&subtle->styles.tray, 0);
+        subStyleFontFlush();
+
+        if (subtle->styles.table) {
+            free(subtle->styles.table);
+        }
 
         subEventFinish();
         subRubyFinish();
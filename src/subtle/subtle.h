@@ -41,7 +41,7 @@
 
 /* Macros {{{ */
 #define FLAGS unsigned int ///< Flags
-#define TAGS unsigned int ///< Tags
+#define TAGS struct subtags_t ///< Tags
 
 #define CLIENTID 1L ///< Client data id
 #define TRAYID 2L ///< Tray data id
@@ -51,7 +51,9 @@
 #define MINH 1L ///< Client min height
 #define WAITTIME 10 ///< Max waiting time
 #define HISTORYSIZE 5 ///< Size of the focus history
-#define DEFAULTTAG (1L << 1) ///< Default tag
+#define DEFAULTTAG 0 ///< Default tag id
+#define TAGSMAX (TAGSWORDS * 32 - 1) ///< Max tags and views per set
+#define TAGSUSED(N) ((N) / 32 + 1) ///< Words used by N tags or views
 
 #define GRAVITYSTRLIMIT 1 ///< Gravity string limit to ignore \0
 
@@ -94,7 +96,7 @@
 #define VISIBLE(C) VISIBLETAGS(C, subtle->visible_tags) ///< Whether client is visible
 
 #define VISIBLETAGS(C, Tags) \
-    (C && (Tags & c->tags \
+    (C && (subTagsMatch(&(Tags), &(C->tags)) \
            || C->flags & (SUB_CLIENT_TYPE_DESKTOP | \
                        SUB_CLIENT_MODE_STICK))) ///< Whether client is visible on tags
 
@@ -233,6 +235,17 @@
 #define SUB_CLIENT_RESTACK_DOWN 0 ///< Restack down
 #define SUB_CLIENT_RESTACK_UP 1 ///< Restack up
 
+/* Client layers */
+#define SUB_CLIENT_LAYER_DESKTOP 0 ///< Desktop layer
+#define SUB_CLIENT_LAYER_GRAVITY 1 ///< Gravity layer
+#define SUB_CLIENT_LAYER_FLOAT 2 ///< Float layer
+#define SUB_CLIENT_LAYER_FULL 3 ///< Full layer
+#define SUB_CLIENT_LAYERS 4 ///< Number of layers
+
+/* Client lists */
+#define SUB_CLIENT_LIST_REPLACE (1L << 0) ///< Rewrite client list
+#define SUB_CLIENT_LIST_STACKING (1L << 1) ///< Rewrite stacking list
+
 /* Drag flags */
 #define SUB_DRAG_START (1L << 0) ///< Drag start
 #define SUB_DRAG_MOVE (1L << 1) ///< Drag move
@@ -302,17 +315,26 @@
 #define SUB_SUBLET_DATA (1L << 14) ///< Sublet data function
 #define SUB_SUBLET_WATCH (1L << 15) ///< Sublet watch function
 #define SUB_SUBLET_UNLOAD (1L << 16) ///< Sublet unload function
+#define SUB_SUBLET_SHARED (1L << 17) ///< Sublet shown on several panels
 
 /* Screen flags */
 #define SUB_SCREEN_PANEL1 (1L << 10) ///< Screen sanel1 enabled
 #define SUB_SCREEN_PANEL2 (1L << 11) ///< Screen sanel2 enabled
 #define SUB_SCREEN_STIPPLE (1L << 12) ///< Screen stipple enabled
 #define SUB_SCREEN_VIRTUAL (1L << 13) ///< Screen is virtual
+#define SUB_SCREEN_DAMAGE (1L << 14) ///< Screen needs full repaint
 
 /* Style flags */
 #define SUB_STYLE_FONT (1L << 10) ///< Style has custom font
 #define SUB_STYLE_SEPARATOR (1L << 11) ///< Style has separator
 
+/* Style states */
+#define SUB_STYLE_STATE_FOCUS (1L << 0) ///< View is focused
+#define SUB_STYLE_STATE_OCCUPIED (1L << 1) ///< View is occupied
+#define SUB_STYLE_STATE_URGENT (1L << 2) ///< View is urgent
+#define SUB_STYLE_STATE_VISIBLE (1L << 3) ///< View is visible
+#define SUB_STYLE_STATES (1L << 4) ///< Number of state combinations
+
 /* Subtle flags */
 #define SUB_SUBTLE_DEBUG (1L << 0) ///< Debug enabled
 #define SUB_SUBTLE_CHECK (1L << 1) ///< Check config
@@ -330,6 +352,8 @@
 #define SUB_SUBTLE_FOCUS_CLICK (1L << 13) ///< Click to focus
 #define SUB_SUBTLE_SKIP_WARP (1L << 14) ///< Skip pointer warp
 #define SUB_SUBTLE_SKIP_URGENT_WARP (1L << 15) ///< Skip urgent warp
+#define SUB_SUBTLE_RENDER (1L << 16) ///< Render panels on next cycle
+#define SUB_SUBTLE_SCAN (1L << 17) ///< Scanning existing windows
 
 /* Tag flags */
 #define SUB_TAG_GRAVITY (1L << 10) ///< Gravity property
@@ -349,11 +373,16 @@
 #define SUB_TRAY_DEAD (1L << 10) ///< Dead window
 #define SUB_TRAY_CLOSE (1L << 12) ///< Send close message
 #define SUB_TRAY_UNMAP (1L << 11) ///< Ignore unmaps
+#define SUB_TRAY_MAPPED (1L << 13) ///< Mapped by panel
 
 /* Text flags */
 #define SUB_TEXT_EMPTY (1L << 0) ///< Empty text
 #define SUB_TEXT_BITMAP (1L << 1) ///< Text bitmap
 #define SUB_TEXT_PIXMAP (1L << 2) ///< Text pixmap
+#define SUB_TEXT_SLOT (1L << 3) ///< Text template slot
+#define SUB_TEXT_DIRTY (1L << 4) ///< Text slot changed
+#define SUB_TEXT_TEMPLATE (1L << 5) ///< Text is a template
+#define SUB_TEXT_ICONS (1L << 6) ///< Text contains icons
 
 /* View flags */
 #define SUB_VIEW_ICON (1L << 10) ///< View icon
@@ -418,12 +447,26 @@
 /* }}} */
 
 /* Typedefs {{{ */
+typedef struct subtags_t /* {{{ */
+{
+    unsigned int words[TAGSWORDS]; ///< Tag set words, id N is bit N + 1
+} SubTags; /* }}} */
+
 typedef struct subarray_t /* {{{ */
 {
-    int ndata; ///< Array data count
+    int ndata, version; ///< Array data count, version of element ids
     void **data; ///< Array data
 } SubArray; /* }}} */
 
+typedef struct subindex_t /* {{{ */
+{
+    int version, nentries, size; ///< Index array version, indexed elements and slots
+    int *ids; ///< Index slots with element id + 1
+    unsigned long *keys; ///< Index slot keys
+    struct subarray_t *array; ///< Index array
+    unsigned long (*key)(void *elem); ///< Index key of element
+} SubIndex; /* }}} */
+
 typedef struct subkeychain_t /* {{{ */
 {
     int len; ///< Keychain length
@@ -443,8 +486,15 @@ typedef struct subclient_t /* {{{ */
     float minr, maxr; ///< Client ratios
     int minw, minh, maxw, maxh, incw, inch, basew, baseh; ///< Client sizes
 
-    int dir, screenid, gravityid; ///< Client restacking dir, current screen id, current gravity id
+    int layer, screenid, gravityid; ///< Client stacking layer, screen id, gravity id
+    int slot; ///< Client hot state slot
+    long stack; ///< Client stacking position in layer
+    int historyid; ///< Client screen focus history id
     int *gravities; ///< Client gravities for views
+
+    struct subclient_t *below, *above; ///< Client stacking neighbours in layer
+    struct subclient_t *newer, *older; ///< Client focus history neighbours
+    struct subclient_t *snewer, *solder; ///< Client focus history neighbours on screen
 } SubClient; /* }}} */
 
 typedef enum subewmh_t /* {{{ */
@@ -528,6 +578,7 @@ typedef enum subewmh_t /* {{{ */
     SUB_EWMH_SUBTLE_TAG_NEW, ///< Subtle tag new
     SUB_EWMH_SUBTLE_TAG_LIST, ///< Subtle tag list
     SUB_EWMH_SUBTLE_TAG_KILL, ///< Subtle tag kill
+    SUB_EWMH_SUBTLE_TAG_REQUEST, ///< Subtle tag set request
     SUB_EWMH_SUBTLE_TRAY_LIST, ///< Subtle tray list
     SUB_EWMH_SUBTLE_VIEW_NEW, ///< Subtle view new
     SUB_EWMH_SUBTLE_VIEW_TAGS, ///< Subtle view tags
@@ -573,6 +624,10 @@ typedef struct subgravity_t { /* {{{ */
     XRectangle geom; ///< Gravity geometry
 } SubGravity; /* }}} */
 
+typedef struct subhistory_t { /* {{{ */
+    struct subclient_t *newest, *oldest; ///< History ends
+} SubHistory; /* }}} */
+
 typedef struct subhook_t { /* {{{ */
     FLAGS flags; ///< Hook flags
     unsigned long proc; ///< Hook proc
@@ -592,7 +647,12 @@ typedef struct subpanel_t { /* {{{ */
         struct subkeychain_t *keychain; ///< Panel chain
         struct subsublet_t *sublet; ///< Panel sublet
         struct subicon_t *icon; ///< Panel icon
+        int *widths; ///< Panel view widths
     };
+
+    unsigned long inputs; ///< Panel hash of measured inputs
+    unsigned long content; ///< Panel hash of drawn content
+    XRectangle drawn; ///< Panel drawn extent
 } SubPanel; /* }}} */
 
 typedef struct subscreen_t { /* {{{ */
@@ -604,6 +664,9 @@ typedef struct subscreen_t { /* {{{ */
     Drawable drawable; ///< Screen drawable
     Window panel1, panel2; ///< Screen windows
     struct subarray_t *panels; ///< Screen panels
+    unsigned long layout; ///< Screen hash of laid out panels
+    int nspatial, nslots; ///< Screen spatial index entries and capacity
+    struct subspatial_t *byx, *byy; ///< Screen spatial index sorted by centre
 } SubScreen; /* }}} */
 
 typedef struct subseparator_t { /* {{{ */
@@ -620,12 +683,20 @@ typedef struct subsublet_t { /* {{{ */
     time_t time, interval; ///< Sublet update/interval time
 
     struct subtext_t *text; ///< Sublet text
+    Pixmap pixmap; ///< Sublet pixmap shared by copies
+    unsigned long content; ///< Sublet hash of pixmap content
 } SubSublet; /* }}} */
 
 typedef struct subsides_t { /* {{{ */
     int top, right, bottom, left; ///< Side values
 } SubSides; /* }}} */
 
+typedef struct subspatial_t { /* {{{ */
+    struct subclient_t *c; ///< Spatial client
+    XRectangle geom; ///< Spatial client geometry
+    int cx, cy; ///< Spatial client centre
+} SubSpatial; /* }}} */
+
 typedef struct substyle_t { /* {{{ */
     FLAGS flags; ///< Style flags
 
@@ -634,6 +705,7 @@ typedef struct substyle_t { /* {{{ */
     long fg, bg, icon, top, right, bottom, left; ///< Style colors
     struct subsides_t border, padding, margin; ///< Style border, padding and margin
     struct subarray_t *styles; ///< Style state list
+    struct subindex_t *index; ///< Style state index
     struct subfont_t *font; ///< Style font
     struct subseparator_t *separator; ///< Style separator
 } SubStyle; /* }}} */
@@ -643,9 +715,10 @@ typedef struct subsubtle_t { /* {{{ */
 
     int loglevel, width, height; ///< Subtle loglevel and screen size
     int ph, step, snap; ///< Subtle properties
-    int visible_tags, visible_views; ///< Subtle visible tags and views
-    int client_tags, urgent_tags; ///< Subtle clients and urgent tags
+    TAGS visible_tags, visible_views; ///< Subtle visible tags and views
+    TAGS client_tags, urgent_tags; ///< Subtle clients and urgent tags
     unsigned long gravity; ///< Subtle default gravity
+    unsigned long generation; ///< Subtle config generation
 
     Display *dpy; ///< Subtle Xorg display
 
@@ -673,16 +746,54 @@ typedef struct subsubtle_t { /* {{{ */
         Window support, focus[HISTORYSIZE], tray;
     } windows; ///< Subtle windows
 
+    XRectangle tray; ///< Subtle tray window geometry applied in panel
+
+    struct {
+        int size, nentries; ///< Hot array capacity and entries
+        struct subclient_t **clients; ///< Hot client of slot in mapping order
+        FLAGS *flags; ///< Hot client flags
+        TAGS *tags; ///< Hot client tags
+        int *screenids, *gravityids; ///< Hot client screen and gravity
+    } hot; ///< Subtle hot client state by client slot
+
+    struct {
+        struct subclient_t *bottom, *top;
+        long lower, upper; ///< Stacking positions of bottom and top
+    } layers[SUB_CLIENT_LAYERS]; ///< Subtle stacking layers
+
+    struct {
+        struct subclient_t *newest, *oldest;
+        struct subhistory_t *screens; ///< Focus history heads by screen id
+        int nscreens; ///< Focus history screen heads
+    } history; ///< Subtle focus history of all clients
+
+    struct {
+        int stale; ///< Spatial index membership state
+    } spatial; ///< Subtle spatial index of visible clients
+
+    struct {
+        FLAGS flags; ///< Client list stale flags
+        Window *wins; ///< Client list in mapping order
+        int nwins; ///< Client list length
+    } list; ///< Subtle published client lists
+
     struct {
         struct subpanel_t tray, keychain;
     } panels; ///< Subtle panels
 
+    struct {
+        struct subindex_t *gravities, *tags, *views;
+    } indices; ///< Subtle lookup indices
+
     struct {
         struct substyle_t all, views, title, sublets, separator, clients, panel_top, panel_bot,
                 tray; ///< Subtle base styles
 
         struct substyle_t *urgent, *occupied, *focus, *visible, *view_sep,
                 *sublet_sep; ///< For faster access to sub-styles
+
+        struct substyle_t *table; ///< Resolved view styles by style and state
+        int ntable; ///< Resolved view styles rows
     } styles; ///< Subtle styles
 
     struct {
@@ -707,15 +818,22 @@ typedef struct subtag_t { /* {{{ */
 typedef struct subtextitem_t { /* {{{ */
     FLAGS flags; ///< Text flags
 
-    int width, height; ///< Text width, height
+    int width, height, len; ///< Text width, height, length
+    int offset, slot; ///< Text offset in buffer, template slot
     long color; ///< Text color
 
-    union subdata_t data; ///< Text data
+    union subdata_t data; ///< Text data, strings point into text buffer
 } SubTextItem; /* }}} */
 
 typedef struct subtext_t { /* {{{ */
-    struct subtextitem_t **items; ///< Item text items
+    struct subtextitem_t *items; ///< Item text items
     int flags, nitems, width; ///< Item flags, count, width
+    int nalloc, left; ///< Text allocated items, left bearing of first item
+
+    char *buf; ///< Text buffer of last parsed text
+    int len, size; ///< Text buffer length and size
+    struct subfont_t *font; ///< Text font of last parse
+    unsigned long serial; ///< Text icon serial, bumped on every parse with icons
 } SubText; /* }}} */
 
 typedef struct subtray_t { /* {{{ */
@@ -725,6 +843,7 @@ typedef struct subtray_t { /* {{{ */
 
     Window win; ///< Tray window
     int width; ///< Tray width
+    XRectangle geom; ///< Tray geometry applied in panel
 } SubTray; /* }}} */
 
 typedef struct subview_t { /* {{{ */
@@ -752,6 +871,9 @@ void subArraySort(SubArray *a, ///< Sort array with given compare function
                   int (*compar)(const void *a, const void *b));
 void subArrayClear(SubArray *a, int clean); ///< Delete all elements
 void subArrayKill(SubArray *a, int clean); ///< Kill array with all elements
+SubIndex *subIndexNew(SubArray *a, unsigned long (*key)(void *elem)); ///< Create index
+int subIndexFind(SubIndex *idx, unsigned long key, int *pos); ///< Find next id with key
+void subIndexKill(SubIndex *idx); ///< Kill index
 /* }}} */
 
 /* client.c {{{ */
@@ -760,6 +882,8 @@ void subClientConfigure(SubClient *c); ///< Send configure request
 void subClientDimension(int id); ///< Dimension clients
 void subClientFocus(SubClient *c, int warp); ///< Focus client
 SubClient *subClientNext(int screenid, int jump); ///< Focus next client
+SubClient *subClientSelect(SubClient *c, int direction); ///< Find client in direction
+void subClientSpatialUpdate(SubClient *c); ///< Update spatial index entry
 void subClientWarp(SubClient *c); ///< Warp pointer to client
 void subClientDrag(SubClient *c, int mode, int direction); ///< Move/drag client
 void subClientUpdate(int vid); ///< Update clients
@@ -781,7 +905,8 @@ void subClientSetTransient(SubClient *c, int *flags); ///< Set client transient
 void subClientSetType(SubClient *c, int *flags); ///< Set client type
 void subClientClose(SubClient *c); ///< Close client
 void subClientKill(SubClient *c); ///< Kill client
-void subClientPublish(int restack); ///< Publish all clients
+void subClientPublish(void); ///< Publish all clients
+void subClientHotStore(SubClient *c); ///< Store hot client state
 /* }}} */
 
 /* display.c {{{ */
@@ -806,15 +931,22 @@ SubEwmh subEwmhFind(Atom atom); ///< Find atom id
 long subEwmhGetWMState(Window win); ///< Get window WM state
 long subEwmhGetXEmbedState(Window win); ///< Get window XEmbed state
 void subEwmhSetWindows(Window win, SubEwmh e, Window *values, int size); ///< Set window properties
+void subEwmhAppendWindows(Window win, SubEwmh e, Window *values,
+                          int size); ///< Append window properties
 void subEwmhSetCardinals(Window win, SubEwmh e, long *values,
                          int size); ///< Set cardinal properties
 void subEwmhSetString(Window win, SubEwmh e,
                       char *value); ///< Set string property
+void subEwmhSetStrings(Window win, SubEwmh e, char **list,
+                       int nlist); ///< Set string list property
+void subEwmhSetTags(Window win, SubEwmh e, TAGS *tags,
+                    int nwords); ///< Set tag set property
 void subEwmhSetWMState(Window win, long state); ///< Set window WM state
 void subEwmhTranslateWMState(Atom atom, int *flags); ///< Translate WM states
 void subEwmhTranslateClientMode(int client_flags, int *flags); ///< Translate client modes
 int subEwmhMessage(Window win, SubEwmh e, long mask, long data0, long data1, long data2, long data3,
                    long data4); ///< Send message
+void subEwmhFlush(void); ///< Flush root properties
 void subEwmhFinish(void); ///< Unset EWMH properties
 /* }}} */
 
@@ -848,12 +980,17 @@ void subHookKill(SubHook *h); ///< Kill hook
 SubPanel *subPanelNew(int type); ///< Create new panel
 void subPanelUpdate(SubPanel *p); ///< Update panels
 void subPanelRender(SubPanel *p, Drawable drawable); ///< Render panels
+int subPanelDamage(SubPanel *p, XRectangle *old); ///< Check panel damage
+int subPanelAsset(unsigned long key, int width, int height, Pixmap source,
+                  Pixmap *pixmap); ///< Get cached panel asset
+void subPanelAssetForget(Pixmap source); ///< Drop assets of icon
 int subPanelCompare(const void *a, const void *b); ///< Compare two panels
 void subPanelAction(SubArray *panels, int type, int x, int y, int button,
                     int bottom); ///< Handle panel action
 void subPanelGeometry(SubPanel *p, SubStyle *s,
                       XRectangle *geom); ///< Get panel geometry
 void subPanelPublish(void); ///< Publish sublets
+SubPanel *subPanelFind(int id); ///< Find published sublet
 void subPanelKill(SubPanel *p); ///< Kill panel
 /* }}} */
 
@@ -878,7 +1015,8 @@ SubScreen *subScreenFind(int x, int y, int *sid); ///< Find screen by coordinate
 SubScreen *subScreenCurrent(int *sid); ///< Get current screen
 void subScreenConfigure(void); ///< Configure screens
 void subScreenUpdate(void); ///< Update screens
-void subScreenRender(void); ///< Render screens
+void subScreenRender(void); ///< Schedule screen render
+void subScreenFlush(void); ///< Render scheduled screens
 void subScreenResize(void); ///< Update screen sizes
 void subScreenWarp(SubScreen *s); ///< Warp pointer to screen
 void subScreenPublish(void); ///< Publish screens
@@ -891,7 +1029,11 @@ SubStyle *subStyleFind(SubStyle *s, char *name, int *idx); ///< Find state
 void subStyleReset(SubStyle *s, int val); ///< Reset style values to given val
 void subStyleMerge(SubStyle *s1, SubStyle *s2); ///< Merge style values
 void subStyleKill(SubStyle *s); ///< Kill style
+SubFont *subStyleFontNew(const char *name); ///< Get shared font
+void subStyleFontKill(SubFont *f); ///< Release shared font
+void subStyleFontFlush(void); ///< Free unused fonts
 void subStyleUpdate(void); ///< Update values
+SubStyle *subStyleView(int styleid, int state); ///< Get resolved view style
 /* }}} */
 
 /* subtle.c {{{ */
@@ -905,14 +1047,144 @@ void subSubtleFinish(void); ///< Finish subtle
 /* tag.c {{{ */
 SubTag *subTagNew(char *name, int *duplicate); ///< Create tag
 void subTagMatcherAdd(SubTag *t, int type, char *pattern, int and); ///< Add a matcher
+void subTagMatcherScan(SubClient *c); ///< Scan client for all tags
 int subTagMatcherCheck(SubTag *t, SubClient *c); ///< Check for match
 void subTagPublish(void); ///< Publish tags
 void subTagKill(SubTag *t); ///< Delete tag
 /* }}} */
 
+/* Tag sets {{{ */
+/* Tag sets are scanned for every client, so keep them inline */
+
+/* subTagsSet {{{ */
+static inline void subTagsSet(SubTags *tags, int id) {
+    if (0 <= id && TAGSMAX > id) {
+        tags->words[(id + 1) / 32] |= (1U << ((id + 1) % 32));
+    }
+} /* }}} */
+
+/* subTagsUnset {{{ */
+static inline void subTagsUnset(SubTags *tags, int id) {
+    if (0 <= id && TAGSMAX > id) {
+        tags->words[(id + 1) / 32] &= ~(1U << ((id + 1) % 32));
+    }
+} /* }}} */
+
+/* subTagsCheck {{{ */
+static inline int subTagsCheck(SubTags *tags, int id) {
+    if (0 <= id && TAGSMAX > id) {
+        return !!(tags->words[(id + 1) / 32] & (1U << ((id + 1) % 32)));
+    }
+
+    return 0;
+} /* }}} */
+
+/* subTagsMatch {{{ */
+static inline int subTagsMatch(SubTags *a, SubTags *b) {
+    int i;
+    unsigned int any = 0;
+
+    /* Fold words without branching */
+    for (i = 0; i < TAGSWORDS; i++) {
+        any |= a->words[i] & b->words[i];
+    }
+
+    return 0 != any;
+} /* }}} */
+
+/* subTagsEmpty {{{ */
+static inline int subTagsEmpty(SubTags *tags) {
+    int i;
+    unsigned int any = 0;
+
+    for (i = 0; i < TAGSWORDS; i++) {
+        any |= tags->words[i];
+    }
+
+    return 0 == any;
+} /* }}} */
+
+/* subTagsAdd {{{ */
+static inline void subTagsAdd(SubTags *tags, SubTags *other) {
+    int i;
+
+    for (i = 0; i < TAGSWORDS; i++) {
+        tags->words[i] |= other->words[i];
+    }
+} /* }}} */
+
+/* subTagsRemove {{{ */
+static inline void subTagsRemove(SubTags *tags, SubTags *other) {
+    int i;
+
+    for (i = 0; i < TAGSWORDS; i++) {
+        tags->words[i] &= ~other->words[i];
+    }
+} /* }}} */
+
+/* subTagsDrop {{{ */
+static inline void subTagsDrop(SubTags *tags, int id) {
+    int i, word = (id + 1) / 32;
+    unsigned int mask = 0, low = 0;
+
+    if (0 > id || TAGSMAX <= id) {
+        return;
+    }
+
+    /* Keep lower bits of the word */
+    mask = (1U << ((id + 1) % 32)) - 1;
+    low = tags->words[word] & mask;
+
+    /* Shift words and carry lowest bit of the next word */
+    for (i = word; i < TAGSWORDS; i++) {
+        tags->words[i] >>= 1;
+
+        if (i + 1 < TAGSWORDS) {
+            tags->words[i] |= tags->words[i + 1] << 31;
+        }
+    }
+
+    tags->words[word] = (tags->words[word] & ~mask) | low;
+} /* }}} */
+
+/* subTagsEncode {{{ */
+static inline void subTagsEncode(SubTags *tags, long *values, int nwords) {
+    int i;
+
+    for (i = 0; i < nwords && i < TAGSWORDS; i++) {
+        values[i] = (long) tags->words[i];
+    }
+} /* }}} */
+/* }}} */
+
+/* Hot state {{{ */
+/* Inline to share the scan with test/bench/clienthot.c */
+
+/* subClientHotCount {{{ */
+static inline int subClientHotCount(int gravityid, int screenid) {
+    int i, used = 0, nentries = subtle->hot.nentries;
+    FLAGS *flags = subtle->hot.flags;
+    TAGS *tags = subtle->hot.tags, visible = subtle->visible_tags;
+    int *gravityids = subtle->hot.gravityids, *screenids = subtle->hot.screenids;
+
+    /* Skip on the narrow arrays first, tags are the widest to load */
+    for (i = 0; i < nentries; i++) {
+        if (gravityids[i] != gravityid || screenids[i] != screenid) continue;
+
+        used += subTagsMatch(&visible, &tags[i])
+                & (0 == (flags[i] & (SUB_CLIENT_MODE_FLOAT | SUB_CLIENT_MODE_FULL)));
+    }
+
+    return used;
+} /* }}} */
+/* }}} */
+
 /* text.c {{{ */
 SubText *subTextNew(void); ///< Create text
 int subTextParse(SubText *t, SubFont *f, char *text); ///< Parse string
+int subTextTemplate(SubText *t, SubFont *f, char *text); ///< Parse template
+int subTextSlots(SubText *t, SubFont *f, char **values, int *lens,
+                 int nvalues); ///< Set template slots
 void subTextRender(SubText *t, SubFont *f, GC gc, Window win, int x, int y, long fg, long icon,
                    long bg); ///< Render text
 void subTextKill(SubText *t); ///< Delete text
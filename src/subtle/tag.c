@@ -13,17 +13,252 @@
 #include "subtle.h"
 
 #define MATCHER(m) ((TagMatcher *) m)
+#define PATTERN(p) ((TagPattern *) p)
+
+#define TAG_PATTERN_EXACT (1L << 0) ///< Pattern is an anchored literal
+#define TAG_PATTERN_PREFIX (1L << 1) ///< Pattern is a literal
+#define TAG_PATTERN_FIELDS 4 ///< Number of matched client fields
 
 /* Typedef {{{ */
+typedef struct tagpattern_t {
+    FLAGS flags; ///< Pattern kind and fields
+    int id, refs, len; ///< Pattern bit, references and literal length
+    char *source, *literal; ///< Pattern source and literal
+    regex_t *regex; ///< Pattern regex
+} TagPattern;
+
 typedef struct tagmatcher_t {
     FLAGS flags;
     struct tagmatcher_t *and;
-    regex_t *regex;
+    struct tagpattern_t *pattern;
 } TagMatcher;
 /* }}} */
 
+static TagPattern **patterns = NULL; ///< Shared patterns by id
+static int npatterns = 0, nused = 0, nbits = 0; ///< Pattern slots, used slots and words per field
+static SubArray *exacts = NULL; ///< Anchored literals
+static SubIndex *literals = NULL;
+static unsigned int *bits = NULL; ///< Pattern matches per field
+static SubClient *scanned = NULL;
+
+static const FLAGS fields[TAG_PATTERN_FIELDS] = {SUB_TAG_MATCH_NAME, SUB_TAG_MATCH_INSTANCE,
+                                                 SUB_TAG_MATCH_CLASS, SUB_TAG_MATCH_ROLE};
+
 /* Private */
 
+/* TagFold {{{ */
+static unsigned long TagFold(const char *str, int len) {
+    int i;
+    unsigned long hash = 2166136261UL;
+
+    /* Hash case-insensitive like the regex */
+    for (i = 0; i < len; i++) {
+        hash = (hash ^ (unsigned char) tolower((unsigned char) str[i])) * 16777619UL;
+    }
+
+    return hash;
+} /* }}} */
+
+/* TagPatternKey {{{ */
+static unsigned long TagPatternKey(void *elem) {
+    return TagFold(PATTERN(elem)->literal, PATTERN(elem)->len);
+} /* }}} */
+
+/* TagPatternParse {{{ */
+static void TagPatternParse(TagPattern *p) {
+    int start = 0, end = strlen(p->source), i;
+
+    /* Matching is anchored at the start anyway */
+    if ('^' == p->source[0]) {
+        start++;
+    }
+
+    if (start < end && '$' == p->source[end - 1]) {
+        p->flags |= TAG_PATTERN_EXACT;
+        end--;
+    }
+
+    /* Anything else than plain characters needs the regex */
+    for (i = start; i < end; i++) {
+        if (!isalnum((unsigned char) p->source[i]) && !strchr("_-/:,@%=", p->source[i])) {
+            p->flags &= ~TAG_PATTERN_EXACT;
+
+            return;
+        }
+    }
+
+    p->len = end - start;
+    p->literal = strndup(p->source + start, p->len);
+
+    if (!(p->flags & TAG_PATTERN_EXACT)) {
+        p->flags |= TAG_PATTERN_PREFIX;
+    }
+} /* }}} */
+
+/* TagPatternNew {{{ */
+static TagPattern *TagPatternNew(char *source) {
+    int i, id = -1;
+    TagPattern *p = NULL;
+
+    /* Share patterns between matchers */
+    for (i = 0; i < npatterns; i++) {
+        if (!patterns[i]) {
+            if (-1 == id) {
+                id = i;
+            }
+        } else if (0 == strcmp(patterns[i]->source, source)) {
+            patterns[i]->refs++;
+
+            return patterns[i];
+        }
+    }
+
+    /* Create pattern */
+    p = PATTERN(subSharedMemoryAlloc(1, sizeof(TagPattern)));
+    p->source = strdup(source);
+    p->refs = 1;
+
+    TagPatternParse(p);
+
+    /* Compile what cannot be compared directly */
+    if (!p->literal && !(p->regex = subSharedRegexNew(source))) {
+        free(p->source);
+        free(p);
+
+        return NULL;
+    }
+
+    /* Add to free or new slot */
+    if (-1 == id) {
+        id = npatterns++;
+        patterns = (TagPattern **) subSharedMemoryRealloc(patterns,
+                                                          npatterns * sizeof(TagPattern *));
+    }
+
+    p->id = id;
+    patterns[id] = p;
+    nused++;
+
+    if (p->flags & TAG_PATTERN_EXACT) {
+        if (!exacts) {
+            exacts = subArrayNew();
+            literals = subIndexNew(exacts, TagPatternKey);
+        }
+
+        subArrayPush(exacts, (void *) p);
+    }
+
+    scanned = NULL;
+
+    return p;
+} /* }}} */
+
+/* TagPatternKill {{{ */
+static void TagPatternKill(TagPattern *p) {
+    if (0 < --p->refs) {
+        return;
+    }
+
+    if (p->flags & TAG_PATTERN_EXACT) {
+        subArrayRemove(exacts, (void *) p);
+    }
+
+    patterns[p->id] = NULL;
+    scanned = NULL;
+
+    if (p->regex) {
+        subSharedRegexKill(p->regex);
+    }
+    if (p->literal) {
+        free(p->literal);
+    }
+
+    free(p->source);
+    free(p);
+
+    /* Release shared state with the last pattern */
+    if (0 == --nused) {
+        if (exacts) {
+            subIndexKill(literals);
+            subArrayKill(exacts, False);
+        }
+
+        free(patterns);
+        free(bits);
+
+        patterns = NULL;
+        exacts = NULL;
+        literals = NULL;
+        bits = NULL;
+        npatterns = nbits = 0;
+    }
+} /* }}} */
+
+/* TagScan {{{ */
+static void TagScan(SubClient *c) {
+    int i, j;
+    char *values[TAG_PATTERN_FIELDS] = {c->name, c->instance, c->klass, c->role};
+
+    /* Resize bitsets to pattern count */
+    if (nbits < (npatterns + 31) / 32) {
+        nbits = (npatterns + 31) / 32;
+        bits = (unsigned int *) subSharedMemoryRealloc(
+                bits, TAG_PATTERN_FIELDS * nbits * sizeof(unsigned int));
+    }
+
+    if (0 < nbits) {
+        memset(bits, 0, TAG_PATTERN_FIELDS * nbits * sizeof(unsigned int));
+    }
+
+    /* Scan each field once for all patterns */
+    for (i = 0; i < TAG_PATTERN_FIELDS; i++) {
+        unsigned int *set = bits + i * nbits;
+        char *value = values[i];
+
+        if (!value) {
+            continue;
+        }
+
+        /* Look up anchored literals, $ also matches before a final newline */
+        if (exacts && 0 < exacts->ndata) {
+            int id, pos = 0, len = strlen(value);
+
+            if (0 < len && '\n' == value[len - 1]) {
+                len--;
+            }
+
+            while (-1 != (id = subIndexFind(literals, TagFold(value, len), &pos))) {
+                TagPattern *p = PATTERN(exacts->data[id]);
+
+                if (p->flags & fields[i] && p->len == len
+                    && 0 == strncasecmp(p->literal, value, len)) {
+                    set[p->id / 32] |= (1U << (p->id % 32));
+                }
+            }
+        }
+
+        /* Check remaining patterns used for this field */
+        for (j = 0; j < npatterns; j++) {
+            TagPattern *p = patterns[j];
+
+            if (p && p->flags & fields[i] && !(p->flags & TAG_PATTERN_EXACT)
+                && (p->literal ? 0 == strncasecmp(value, p->literal, p->len)
+                               : subSharedRegexMatch(p->regex, value))) {
+                set[j / 32] |= (1U << (j % 32));
+            }
+        }
+    }
+
+    scanned = c;
+} /* }}} */
+
+/* TagScanned {{{ */
+static int TagScanned(TagMatcher *m, int field) {
+    int id = m->pattern->id;
+
+    return m->flags & fields[field] && bits[field * nbits + id / 32] & (1U << (id % 32));
+} /* }}} */
+
 /* TagClear {{{ */
 static void TagClear(SubTag *t) {
     int i;
@@ -34,8 +269,8 @@ static void TagClear(SubTag *t) {
     for (i = 0; t->matcher && i < t->matcher->ndata; i++) {
         TagMatcher *m = (TagMatcher *) t->matcher->data[i];
 
-        if (m->regex) {
-            subSharedRegexKill(m->regex);
+        if (m->pattern) {
+            TagPatternKill(m->pattern);
         }
 
         free(m);
@@ -44,16 +279,28 @@ static void TagClear(SubTag *t) {
     subArrayClear(t->matcher, False);
 } /* }}} */
 
+/* TagKey {{{ */
+static unsigned long TagKey(void *elem) {
+    return subSharedHash(0, TAG(elem)->name, strlen(TAG(elem)->name));
+} /* }}} */
+
 /* TagFind {{{ */
 static SubTag *TagFind(char *name) {
-    int i;
+    int id, pos = 0;
+    unsigned long key = 0;
     SubTag *t = NULL;
 
     assert(name);
 
-    /* Linear search */
-    for (i = 0; i < subtle->tags->ndata; i++) {
-        t = TAG(subtle->tags->data[i]);
+    if (!subtle->indices.tags) {
+        subtle->indices.tags = subIndexNew(subtle->tags, TagKey);
+    }
+
+    /* Hashed search */
+    key = subSharedHash(0, name, strlen(name));
+
+    while (-1 != (id = subIndexFind(subtle->indices.tags, key, &pos))) {
+        t = TAG(subtle->tags->data[id]);
 
         if (0 == strcmp(t->name, name)) {
             return t;
@@ -66,16 +313,9 @@ static SubTag *TagFind(char *name) {
 /* TagMatch {{{ */
 static int TagMatch(TagMatcher *m, SubClient *c) {
     /* Complex matching */
-    if ((m->regex &&
-         /* Check WM_NAME */
-         ((m->flags & SUB_TAG_MATCH_NAME && c->name && subSharedRegexMatch(m->regex, c->name))
-          /* Check instance part of WM_CLASS */
-          || (m->flags & SUB_TAG_MATCH_INSTANCE && c->instance
-          && subSharedRegexMatch(m->regex, c->instance))
-          /* Check class part of WM_CLASS */
-          || (m->flags & SUB_TAG_MATCH_CLASS && c->klass && subSharedRegexMatch(m->regex, c->klass))
-          /* Check WM_ROLE */
-          || (m->flags & SUB_TAG_MATCH_ROLE && c->role && subSharedRegexMatch(m->regex, c->role))))
+    if ((m->pattern &&
+         /* Check WM_NAME, WM_CLASS and WM_ROLE from scan */
+         (TagScanned(m, 0) || TagScanned(m, 1) || TagScanned(m, 2) || TagScanned(m, 3)))
         /* Check _NET_WM_WINDOW_TYPE */
         || (m->flags & SUB_TAG_MATCH_TYPE
          && c->flags & (m->flags & (SUB_CLIENT_TYPE_NORMAL | TYPES_ALL))))
@@ -126,25 +366,28 @@ SubTag *subTagNew(char *name, int *duplicate) {
 
 void subTagMatcherAdd(SubTag *t, int type, char *pattern, int and) {
     TagMatcher *m = NULL;
-    regex_t *regex = NULL;
+    TagPattern *p = NULL;
 
     assert(t);
 
     /* Prevent emtpy regex */
     if (pattern && 0 != strlen(pattern))
-        regex = subSharedRegexNew(pattern);
+        p = TagPatternNew(pattern);
 
     /* Remove matcher types that need a regexp */
-    if (!regex)
+    if (!p)
         type &= ~(SUB_TAG_MATCH_NAME | SUB_TAG_MATCH_INSTANCE | SUB_TAG_MATCH_CLASS |
                   SUB_TAG_MATCH_ROLE);
+    else
+        p->flags |= type & (SUB_TAG_MATCH_NAME | SUB_TAG_MATCH_INSTANCE | SUB_TAG_MATCH_CLASS |
+                            SUB_TAG_MATCH_ROLE);
 
     /* Check if anything is left for matching */
     if (0 < type) {
         /* Create new matcher */
         m = MATCHER(subSharedMemoryAlloc(1, sizeof(TagMatcher)));
         m->flags = type;
-        m->regex = regex;
+        m->pattern = p;
 
         /* Create on demand to safe memory */
         if (NULL == t->matcher) {
@@ -157,9 +400,22 @@ void subTagMatcherAdd(SubTag *t, int type, char *pattern, int and) {
         }
 
         subArrayPush(t->matcher, (void *) m);
+    } else if (p) {
+        TagPatternKill(p);
     }
 } /* }}} */
 
+/** subTagMatcherScan {{{
+ * @brief Match client fields against all patterns
+ * @param[in]  c  A #SubClient
+ **/
+
+void subTagMatcherScan(SubClient *c) {
+    assert(c);
+
+    TagScan(c);
+} /* }}} */
+
 /** subTagMatcherCheck {{{
  * @brief Check if client matches tag
  * @param[in]  t  A #SubTag
@@ -173,6 +429,11 @@ int subTagMatcherCheck(SubTag *t, SubClient *c) {
 
     assert(t && c);
 
+    /* Scan fields unless done for this client */
+    if (c != scanned) {
+        TagScan(c);
+    }
+
     /* Check if a matcher and client fit together */
     for (i = 0; t->matcher && i < t->matcher->ndata; i++) {
         TagMatcher *m = MATCHER(t->matcher->data[i]);
@@ -243,7 +504,7 @@ void subTagPublish(void) {
     }
 
     /* EWMH: Tag list */
-    subSharedPropertySetStrings(subtle->dpy, ROOT, subEwmhGet(SUB_EWMH_SUBTLE_TAG_LIST), names, i);
+    subEwmhSetStrings(ROOT, SUB_EWMH_SUBTLE_TAG_LIST, names, i);
 
     XSync(subtle->dpy, False); ///< Sync all changes
 
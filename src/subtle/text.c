@@ -12,6 +12,155 @@
 
 #include "subtle.h"
 
+/* TextWidth {{{ */
+static int TextWidth(SubText *t) {
+    int i, width = 0;
+
+    /* Sum items with spacing */
+    for (i = 0; i < t->nitems; i++) {
+        SubTextItem *item = &t->items[i];
+
+        if (item->flags & (SUB_TEXT_BITMAP | SUB_TEXT_PIXMAP)) {
+            width += item->width + (0 == i ? 3 : 6); ///< Add spacing and check if icon is first
+        } else {
+            width += item->width - (0 == i ? t->left : 0); ///< Remove left bearing of first item
+        }
+    }
+
+    /* Fix spacing of last icon */
+    if (0 < t->nitems && t->items[t->nitems - 1].flags & (SUB_TEXT_BITMAP | SUB_TEXT_PIXMAP)) {
+        width -= 2;
+    }
+
+    return width;
+} /* }}} */
+
+/* TextMeasure {{{ */
+static void TextMeasure(SubText *t, SubFont *f, int idx) {
+    int left = 0, right = 0;
+    SubTextItem *item = &t->items[idx];
+
+    item->width = subSharedStringWidth(subtle->dpy, f, item->data.string, item->len, &left,
+                                       &right, False);
+
+    /* Store left bearing of first item and remove right bearing of last */
+    if (0 == idx) {
+        t->left = left;
+    }
+
+    if (idx == t->nitems - 1) {
+        item->width -= right;
+    }
+} /* }}} */
+
+/* TextParse {{{ */
+static int TextParse(SubText *t, SubFont *f, char *text, int template) {
+    int i, len = 0;
+    char *tok = NULL, *end = NULL;
+    long color = -1, pixmap = 0;
+    SubTextItem *item = NULL;
+
+    len = strlen(text);
+
+    /* Skip identical input, icons may have been redrawn under the same id */
+    if (t->buf && !(t->flags & SUB_TEXT_ICONS) && t->font == f && t->len == len
+        && template == !!(t->flags & SUB_TEXT_TEMPLATE) && 0 == memcmp(t->buf, text, len))
+    {
+        return t->width;
+    }
+
+    /* Keep a copy, items point into it */
+    if (t->size <= len) {
+        t->size = len + 1;
+        t->buf = (char *) subSharedMemoryRealloc(t->buf, t->size);
+    }
+
+    memcpy(t->buf, text, len + 1);
+
+    t->len = len;
+    t->font = f;
+    t->left = 0;
+    t->nitems = 0;
+    t->flags = template ? SUB_TEXT_TEMPLATE : 0;
+
+    /* Iterate over tokens */
+    for (tok = t->buf; tok; tok = ('\0' != tok[len] ? tok + len + 1 : NULL)) {
+        len = strcspn(tok, SEPARATOR);
+
+        if ('#' == *tok) {
+            color = strtol(tok + 1, NULL, 0); ///< Color
+        } else if (0 < len) { ///< Text, icon or slot
+            /* Re-use items to save alloc cycles */
+            if (t->nitems == t->nalloc) {
+                t->nalloc = t->nalloc ? 2 * t->nalloc : 4;
+                t->items = (SubTextItem *) subSharedMemoryRealloc(t->items,
+                                                                  t->nalloc * sizeof(SubTextItem));
+            }
+
+            item = &t->items[(t->nitems)++];
+            item->flags = 0;
+            item->color = color;
+            item->offset = tok - t->buf;
+            item->slot = -1;
+
+            /* Get geometry of bitmap/pixmap */
+            if (('!' == *tok || '&' == *tok) && (pixmap = strtol(tok + 1, &end, 0))) {
+                XRectangle geometry = {0};
+
+                /* Prefer size passed along with the icon */
+                if (':' == *end) {
+                    long width = strtol(end + 1, &end, 0);
+                    long height = 'x' == *end ? strtol(end + 1, NULL, 0) : 0;
+
+                    /* Ignore bogus sizes */
+                    if (0 < width && 0 < height && USHRT_MAX >= width && USHRT_MAX >= height) {
+                        geometry.width = width;
+                        geometry.height = height;
+                    }
+                }
+
+                /* Ask server when no valid size was passed along */
+                if (0 == geometry.width) {
+                    subSharedPropertyGeometry(subtle->dpy, pixmap, &geometry);
+                }
+
+                item->flags |= ('!' == *tok ? SUB_TEXT_BITMAP : SUB_TEXT_PIXMAP);
+                t->flags |= SUB_TEXT_ICONS;
+                item->data.num = pixmap;
+                item->width = geometry.width;
+                item->height = geometry.height;
+                item->len = 0;
+            } else if (template && '$' == *tok && 0 < (item->slot = strtol(tok + 1, NULL, 0))) {
+                item->flags |= SUB_TEXT_SLOT;
+                item->offset = t->len; ///< Empty until set
+                item->data.string = t->buf + item->offset;
+                item->len = 0;
+                item->width = 0;
+                item->slot--;
+            } else { ///< Ordinary text
+                item->data.string = tok;
+                item->len = len;
+            }
+        }
+    }
+
+    /* Measure static text once */
+    for (i = 0; i < t->nitems; i++) {
+        if (!(t->items[i].flags & (SUB_TEXT_BITMAP | SUB_TEXT_PIXMAP | SUB_TEXT_SLOT))) {
+            TextMeasure(t, f, i);
+        }
+    }
+
+    t->width = TextWidth(t);
+
+    /* Icon contents can't be compared, so invalidate on every update */
+    if (t->flags & SUB_TEXT_ICONS) {
+        t->serial++;
+    }
+
+    return t->width;
+} /* }}} */
+
 /** subTextNew {{{
  * @brief Create new text
  **/
@@ -27,79 +176,111 @@ SubText *subTextNew(void) { return TEXT(subSharedMemoryAlloc(1, sizeof(SubText))
  **/
 
 int subTextParse(SubText *t, SubFont *f, char *text) {
-    int i = 0, left = 0, right = 0;
-    char *tok = NULL;
-    long color = -1, pixmap = 0;
-    SubTextItem *item = NULL;
+    assert(f && t && text);
 
-    assert(f && t);
+    return TextParse(t, f, text, False);
+} /* }}} */
 
-    t->width = 0;
+/** subTextTemplate {{{
+ * @brief Parse a template with numbered slots like ^$1^ and store it in given text
+ * @param]inout]  t     A #SubText
+ * @param[inout]  f     A #SubFont
+ * @param[in]     text  Template to parse
+ * @return Returns the length of the text in chars
+ **/
 
-    /* Split and iterate over tokens */
-    while ((tok = strsep(&text, SEPARATOR))) {
-        if ('#' == *tok) {
-            color = strtol(tok + 1, NULL, 0); ///< Color
-        } else if ('\0' != *tok) { ///< Text or icon
-            /* Re-use items to save alloc cycles */
-            if (i < t->nitems && (item = ITEM(t->items[i]))) {
-                if (!(item->flags & (SUB_TEXT_BITMAP | SUB_TEXT_PIXMAP)) && item->data.string) {
-                    free(item->data.string);
-                }
+int subTextTemplate(SubText *t, SubFont *f, char *text) {
+    assert(f && t && text);
 
-                item->flags &= ~(SUB_TEXT_EMPTY | SUB_TEXT_BITMAP | SUB_TEXT_PIXMAP);
-            } else if ((item = ITEM(subSharedMemoryAlloc(1, sizeof(SubTextItem))))) {
-                /* Add icon to array */
-                t->items = (SubTextItem **) subSharedMemoryRealloc(
-                        t->items, (t->nitems + 1) * sizeof(SubTextItem *));
-                t->items[(t->nitems)++] = item;
-            }
+    return TextParse(t, f, text, True);
+} /* }}} */
 
-            /* Get geometry of bitmap/pixmap */
-            if (('!' == *tok || '&' == *tok) && (pixmap = strtol(tok + 1, NULL, 0))) {
-                XRectangle geometry = {0};
+/** subTextSlots {{{
+ * @brief Set slot values of a template and measure only changed slots
+ * @param]inout]  t        A #SubText
+ * @param[inout]  f        A #SubFont
+ * @param[in]     values   Slot values
+ * @param[in]     lens     Length of slot values
+ * @param[in]     nvalues  Number of values
+ * @return Returns the length of the text in chars
+ **/
 
-                subSharedPropertyGeometry(subtle->dpy, pixmap, &geometry);
+int subTextSlots(SubText *t, SubFont *f, char **values, int *lens, int nvalues) {
+    int i, size = 0, changed = 0;
+    char *buf = NULL;
 
-                item->flags |= ('!' == *tok ? SUB_TEXT_BITMAP : SUB_TEXT_PIXMAP);
-                item->data.num = pixmap;
-                item->width = geometry.width;
-                item->height = geometry.height;
+    assert(f && t && values && lens);
 
-                /* Add spacing and check if icon is first */
-                t->width += item->width + (0 == i ? 3 : 6);
+    if (!(t->flags & SUB_TEXT_TEMPLATE)) {
+        return t->width;
+    }
 
-                item->color = color;
-            } else { ///< Ordinary text
-                item->data.string = strdup(tok);
-                item->width = subSharedStringWidth(subtle->dpy, f, tok, strlen(tok), &left, &right,
-                                                   False);
+    /* Icons of the template may have been redrawn */
+    if (t->flags & SUB_TEXT_ICONS) {
+        t->serial++;
+    }
 
-                /* Remove left bearing from first text item */
-                t->width += item->width - (0 == i ? left : 0);
+    /* Mark changed slots */
+    for (i = 0; i < t->nitems; i++) {
+        SubTextItem *item = &t->items[i];
 
-                item->color = color;
+        if (item->flags & SUB_TEXT_SLOT) {
+            int len = item->slot < nvalues ? lens[item->slot] : 0;
+
+            if (item->len != len
+                || (0 < len && 0 != memcmp(item->data.string, values[item->slot], len)))
+            {
+                item->flags |= SUB_TEXT_DIRTY;
+                changed++;
             }
 
-            i++;
+            size += len + 1;
         }
     }
 
-    /* Mark other items as clean */
-    for (; i < t->nitems; i++) {
-        ITEM(t->items[i])->flags |= SUB_TEXT_EMPTY;
+    if (0 == changed) {
+        return t->width;
     }
 
-    /* Fix spacing of last item */
-    if (item) {
-        if (item->flags & (SUB_TEXT_BITMAP | SUB_TEXT_PIXMAP)) {
-            t->width -= 2;
-        } else {
-            t->width -= right;
-            item->width -= right;
+    /* Values follow the template in the buffer */
+    if (t->size < t->len + 1 + size) {
+        t->size = t->len + 1 + size;
+        t->buf = (char *) subSharedMemoryRealloc(t->buf, t->size);
+    }
+
+    buf = t->buf + t->len + 1;
+
+    for (i = 0; i < t->nitems; i++) {
+        SubTextItem *item = &t->items[i];
+
+        if (item->flags & SUB_TEXT_SLOT) {
+            item->len = 0;
+            item->offset = buf - t->buf;
+
+            if (item->slot < nvalues) {
+                item->len = lens[item->slot];
+
+                memcpy(buf, values[item->slot], item->len);
+            }
+
+            buf[item->len] = '\0';
+            buf += item->len + 1;
+        }
+
+        /* Buffer may have moved */
+        if (!(item->flags & (SUB_TEXT_BITMAP | SUB_TEXT_PIXMAP))) {
+            item->data.string = t->buf + item->offset;
+        }
+
+        if (item->flags & SUB_TEXT_DIRTY) {
+            item->flags &= ~SUB_TEXT_DIRTY;
+
+            TextMeasure(t, f, i);
         }
     }
 
+    t->width = TextWidth(t);
+
     return t->width;
 } /* }}} */
 
@@ -124,7 +305,7 @@ void subTextRender(SubText *t, SubFont *f, GC gc, Window win, int x, int y, long
 
     /* Render text items */
     for (i = 0; i < t->nitems; i++) {
-        SubTextItem *item = ITEM(t->items[i]);
+        SubTextItem *item = &t->items[i];
 
         if (item->flags & SUB_TEXT_EMPTY) { ///< Empty text
             break; ///< Break loop
@@ -141,7 +322,7 @@ void subTextRender(SubText *t, SubFont *f, GC gc, Window win, int x, int y, long
         } else { ///< Text
             subSharedDrawString(subtle->dpy, gc, f, win, width, y,
                                 (-1 == item->color) ? fg : item->color, bg, item->data.string,
-                                strlen(item->data.string));
+                                item->len);
 
             width += item->width;
         }
@@ -154,21 +335,15 @@ void subTextRender(SubText *t, SubFont *f, GC gc, Window win, int x, int y, long
  **/
 
 void subTextKill(SubText *t) {
-    int i;
-
     assert(t);
 
-    for (i = 0; i < t->nitems; i++) {
-        SubTextItem *item = (SubTextItem *) t->items[i];
-
-        if (!(item->flags & (SUB_TEXT_BITMAP | SUB_TEXT_PIXMAP)) && item->data.string) {
-            free(item->data.string);
-        }
-
-        free(t->items[i]);
+    if (t->items) {
+        free(t->items);
+    }
+    if (t->buf) {
+        free(t->buf);
     }
 
-    free(t->items);
     free(t);
 } /* }}} */
 
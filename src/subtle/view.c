@@ -12,6 +12,27 @@
 
 #include "subtle.h"
 
+/* ViewKey {{{ */
+static unsigned long ViewKey(void *elem) {
+    return (unsigned long) elem;
+} /* }}} */
+
+/* ViewIndex {{{ */
+static int ViewIndex(SubView *v) {
+    int id, pos = 0;
+
+    if (!subtle->indices.views) {
+        subtle->indices.views = subIndexNew(subtle->views, ViewKey);
+    }
+
+    /* Keys are addresses, so the first hit is the view */
+    if (-1 != (id = subIndexFind(subtle->indices.views, (unsigned long) v, &pos))) {
+        return id;
+    }
+
+    return -1;
+} /* }}} */
+
 /** subViewNew {{{
  * @brief Create a new view
  * @param[in]  name  Name of the view
@@ -37,7 +58,7 @@ SubView *subViewNew(char *name, char *tags) {
 
         for (i = 0; i < subtle->tags->ndata; i++) {
             if (subSharedRegexMatch(preg, TAG(subtle->tags->data[i])->name)) {
-                v->tags |= (1L << (i + 1));
+                subTagsSet(&v->tags, i);
             }
         }
 
@@ -66,11 +87,11 @@ void subViewFocus(SubView *v, int screenid, int swap, int focus) {
 
     /* Select screen and find vid */
     s1 = SCREEN(subArrayGet(subtle->screens, screenid));
-    vid = subArrayIndex(subtle->views, (void *) v);
+    vid = ViewIndex(v);
 
     if (s1) {
         /* Check if view is visible on any screen */
-        if (subtle->visible_views & (1L << (vid + 1))) {
+        if (subTagsCheck(&subtle->visible_views, vid)) {
             /* This only makes sense with more than one screen
              * otherwise just ignore that */
             if (1 < subtle->screens->ndata) {
@@ -134,6 +155,7 @@ void subViewKill(SubView *v) {
     subHookCall((SUB_HOOK_TYPE_VIEW | SUB_HOOK_ACTION_KILL), (void *) v);
 
     if (v->icon) {
+        subPanelAssetForget(v->icon->pixmap);
         free(v->icon);
     }
     free(v->name);
@@ -149,33 +171,32 @@ void subViewKill(SubView *v) {
  **/
 
 void subViewPublish(void) {
-    int i;
+    int i, nwords = TAGSUSED(subtle->tags->ndata);
     long vid = 0, *tags = NULL, *icons = NULL;
     char **names = NULL;
 
     if (0 < subtle->views->ndata) {
-        tags = (long *) subSharedMemoryAlloc(subtle->views->ndata, sizeof(long));
+        tags = (long *) subSharedMemoryAlloc(subtle->views->ndata * nwords, sizeof(long));
         icons = (long *) subSharedMemoryAlloc(subtle->views->ndata, sizeof(long));
         names = (char **) subSharedMemoryAlloc(subtle->views->ndata, sizeof(char *));
 
         for (i = 0; i < subtle->views->ndata; i++) {
             SubView *v = VIEW(subtle->views->data[i]);
 
-            tags[i] = v->tags;
+            subTagsEncode(&v->tags, tags + i * nwords, nwords);
             icons[i] = v->icon ? v->icon->pixmap : -1;
             names[i] = v->name;
         }
 
-        /* EWMH: Tags */
-        subEwmhSetCardinals(ROOT, SUB_EWMH_SUBTLE_VIEW_TAGS, tags, subtle->views->ndata);
+        /* EWMH: Tags (words per view follow from the property size) */
+        subEwmhSetCardinals(ROOT, SUB_EWMH_SUBTLE_VIEW_TAGS, tags, subtle->views->ndata * nwords);
 
         /* EWMH: Icons */
         subEwmhSetCardinals(ROOT, SUB_EWMH_SUBTLE_VIEW_ICONS, icons, subtle->views->ndata);
 
         /* EWMH: Desktops */
         subEwmhSetCardinals(ROOT, SUB_EWMH_NET_NUMBER_OF_DESKTOPS, (long *) &i, 1);
-        subSharedPropertySetStrings(subtle->dpy, ROOT, subEwmhGet(SUB_EWMH_NET_DESKTOP_NAMES),
-                                    names, subtle->views->ndata);
+        subEwmhSetStrings(ROOT, SUB_EWMH_NET_DESKTOP_NAMES, names, subtle->views->ndata);
 
         /* EWMH: Current desktop */
         subEwmhSetCardinals(ROOT, SUB_EWMH_NET_CURRENT_DESKTOP, &vid, 1);
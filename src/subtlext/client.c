@@ -326,7 +326,7 @@ VALUE subextClientSingCurrent(VALUE self) {
 VALUE subextClientSingVisible(VALUE self) {
     int i, nclients = 0;
     Window *clients        = NULL;
-    unsigned long *visible = NULL;
+    unsigned long *visible = NULL, nvisible = 0;
     VALUE meth = Qnil, klass = Qnil, array = Qnil, client = Qnil;
 
     subextSubtlextConnect(NULL); ///< Implicit open connection
@@ -338,17 +338,18 @@ VALUE subextClientSingVisible(VALUE self) {
     clients = subextSubtlextWindowList("_NET_CLIENT_LIST", &nclients);
     visible = (unsigned long *) subSharedPropertyGet(
             display, DefaultRootWindow(display), XA_CARDINAL,
-            XInternAtom(display, "SUBTLE_VISIBLE_TAGS", False), NULL);
+            XInternAtom(display, "SUBTLE_VISIBLE_TAGS", False), &nvisible);
 
     /* Check results */
     if (clients && visible) {
         for (i = 0; i < nclients; i++) {
+            unsigned long ntags = 0;
             unsigned long *tags = (unsigned long *) subSharedPropertyGet(
                     display, clients[i], XA_CARDINAL,
-                    XInternAtom(display, "SUBTLE_CLIENT_TAGS", False), NULL);
+                    XInternAtom(display, "SUBTLE_CLIENT_TAGS", False), &ntags);
 
             /* Create client on match */
-            if (tags && *tags && *visible & *tags &&
+            if (tags && subextSubtlextTagsMatch(visible, nvisible, tags, ntags) &&
                 RTEST(client = rb_funcall(klass, meth, 1, LONG2NUM(clients[i])))) {
                 subextClientUpdate(client);
                 rb_ary_push(array, client);
@@ -550,7 +551,8 @@ VALUE subextClientUpdate(VALUE self) {
 
     /* Check values */
     if (0 <= (win = NUM2LONG(rb_iv_get(self, "@win")))) {
-        int *tags = NULL, *flags = NULL;
+        int *flags = NULL;
+        unsigned long *tags = NULL, ntags = 0;
         char *wmname = NULL, *wminstance = NULL, *wmclass = NULL, *role = NULL;
 
         /* Fetch name, instance and class */
@@ -558,8 +560,9 @@ VALUE subextClientUpdate(VALUE self) {
         subSharedPropertyName(display, win, &wmname, wmclass);
 
         /* Fetch tags, flags and role */
-        tags = (int *) subSharedPropertyGet(
-                display, win, XA_CARDINAL, XInternAtom(display, "SUBTLE_CLIENT_TAGS", False), NULL);
+        tags = (unsigned long *) subSharedPropertyGet(
+                display, win, XA_CARDINAL, XInternAtom(display, "SUBTLE_CLIENT_TAGS", False),
+                &ntags);
         flags = (int *) subSharedPropertyGet(display, win, XA_CARDINAL,
                                              XInternAtom(display, "SUBTLE_CLIENT_FLAGS", False),
                                              NULL);
@@ -567,7 +570,7 @@ VALUE subextClientUpdate(VALUE self) {
                                      XInternAtom(display, "WM_WINDOW_ROLE", False), NULL);
 
         /* Set properties */
-        rb_iv_set(self, "@tags", tags ? INT2FIX(*tags) : INT2FIX(0));
+        rb_iv_set(self, "@tags", subextSubtlextTagsToValue(tags, ntags));
         rb_iv_set(self, "@flags", flags ? INT2FIX(*flags) : INT2FIX(0));
         rb_iv_set(self, "@name", rb_str_new2(wmname));
         rb_iv_set(self, "@instance", rb_str_new2(wminstance));
@@ -615,6 +618,7 @@ VALUE subextClientViewList(VALUE self) {
     char **names = NULL;
     VALUE win = Qnil, array = Qnil, method = Qnil, klass = Qnil;
     unsigned long *view_tags = NULL, *client_tags = NULL, *flags = NULL;
+    unsigned long nview_tags = 0, nclient_tags = 0;
 
     /* Check ruby object */
     rb_check_frozen(self);
@@ -630,19 +634,23 @@ VALUE subextClientViewList(VALUE self) {
                                             XInternAtom(display, "_NET_DESKTOP_NAMES", False), &nnames);
     view_tags = (unsigned long *) subSharedPropertyGet(
             display, DefaultRootWindow(display), XA_CARDINAL,
-            XInternAtom(display, "SUBTLE_VIEW_TAGS", False), NULL);
+            XInternAtom(display, "SUBTLE_VIEW_TAGS", False), &nview_tags);
     client_tags = (unsigned long *) subSharedPropertyGet(
             display, NUM2LONG(win), XA_CARDINAL, XInternAtom(display, "SUBTLE_CLIENT_TAGS", False),
-            NULL);
+            &nclient_tags);
     flags = (unsigned long *) subSharedPropertyGet(
             display, NUM2LONG(win), XA_CARDINAL, XInternAtom(display, "SUBTLE_CLIENT_FLAGS", False),
             NULL);
 
     /* Check results */
-    if (names && view_tags && client_tags) {
+    if (names && view_tags && client_tags && 0 < nnames) {
+        int nwords = nview_tags / nnames; ///< Words per view
+
         for (i = 0; i < nnames; i++) {
             /* Check if there are common tags or window is stick */
-            if ((view_tags[i] & *client_tags) || (flags && *flags & SUB_EWMH_STICK)) {
+            if (subextSubtlextTagsMatch(view_tags + i * nwords, nwords, client_tags, nclient_tags)
+                || (flags && *flags & SUB_EWMH_STICK))
+            {
                 /* Create new view */
                 VALUE v = rb_funcall(klass, method, 1, rb_str_new2(names[i]));
 
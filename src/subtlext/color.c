@@ -35,7 +35,7 @@ VALUE ColorEqual(VALUE self, VALUE other, int check_type) {
 
 /* ColorPixelToRGB {{{ */
 static void ColorPixelToRGB(XColor *xcolor) {
-    XQueryColor(display, DefaultColormap(display, DefaultScreen(display)), xcolor);
+    subSharedColorQuery(display, xcolor);
 
     /* Scale 65535 to 255 */
     xcolor->red = SCALE(xcolor->red, 65535, 255);
@@ -50,7 +50,7 @@ static void ColorRGBToPixel(XColor *xcolor) {
     xcolor->green = SCALE(xcolor->green, 255, 65535);
     xcolor->blue = SCALE(xcolor->blue, 255, 65535);
 
-    XAllocColor(display, DefaultColormap(display, DefaultScreen(display)), xcolor);
+    subSharedColorAlloc(display, xcolor);
 
     /* Scale 65535 to 255 */
     xcolor->red = SCALE(xcolor->red, 65535, 255);
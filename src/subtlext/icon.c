@@ -600,7 +600,7 @@ VALUE subextIconAskBitmap(VALUE self) {
  * Convert this Icon object to string.
  *
  *  puts icon
- *  => "<>!4<>"
+ *  => "<>!4:16x16<>"
  */
 
 VALUE subextIconToString(VALUE self) {
@@ -609,10 +609,11 @@ VALUE subextIconToString(VALUE self) {
 
     Data_Get_Struct(self, SubtlextIcon, i);
     if (i) {
-        char buf[20] = {0};
+        char buf[48] = {0};
 
-        snprintf(buf, sizeof(buf), "%s%c%ld%s", SEPARATOR, i->flags & ICON_PIXMAP ? '&' : '!',
-                 i->pixmap, SEPARATOR);
+        /* Pass size along to spare the lookup */
+        snprintf(buf, sizeof(buf), "%s%c%ld:%ux%u%s", SEPARATOR, i->flags & ICON_PIXMAP ? '&' : '!',
+                 i->pixmap, i->width, i->height, SEPARATOR);
         ret = rb_str_new2(buf);
     }
 
@@ -626,7 +627,7 @@ VALUE subextIconToString(VALUE self) {
  * Convert this Icon to string and concat given string.
  *
  *  icon + "subtle"
- *  => "<>!4<>subtle"
+ *  => "<>!4:16x16<>subtle"
  */
 
 VALUE subextIconOperatorPlus(VALUE self, VALUE value) {
@@ -640,7 +641,7 @@ VALUE subextIconOperatorPlus(VALUE self, VALUE value) {
  * Convert this Icon to string and concat it multiple times.
  *
  *  icon * 2
- *  => "<>!4<><>!4<>"
+ *  => "<>!4:16x16<><>!4:16x16<>"
  */
 
 VALUE subextIconOperatorMult(VALUE self, VALUE value) {
@@ -201,15 +201,15 @@ static int SubtlextXError(Display *disp, XErrorEvent *ev) {
 /* Tags */
 
 /* SubtlextTagFind {{{ */
-static int SubtlextTagFind(VALUE value) {
-    int tags = 0;
+static void SubtlextTagFind(VALUE value, unsigned long *tags) {
+    int id = -1;
 
     /* Check object type */
     switch (rb_type(value)) {
         case T_SYMBOL:
             /* Falls-through */
         case T_STRING: {
-            int id, flags = 0;
+            int flags = 0;
             char *string = NULL;
 
             /* Handle symbols and strings */
@@ -221,17 +221,15 @@ static int SubtlextTagFind(VALUE value) {
             }
 
             /* Find tag and get id */
-            if (-1 != (id = subextSubtlextFindString("SUBTLE_TAG_LIST", string, NULL, flags))) {
-                tags |= (1L << (id + 1));
-            }
+            id = subextSubtlextFindString("SUBTLE_TAG_LIST", string, NULL, flags);
         } break;
         case T_OBJECT:
             /* Check instance type and fetch id */
             if (rb_obj_is_instance_of(value, rb_const_get(mod, rb_intern("Tag")))) {
-                VALUE id = Qnil;
+                VALUE vid = Qnil;
 
-                if (FIXNUM_P((id = rb_iv_get(value, "@id")))) {
-                    tags |= (1L << (FIX2INT(id) + 1));
+                if (FIXNUM_P((vid = rb_iv_get(value, "@id")))) {
+                    id = FIX2INT(vid);
                 }
             }
             break;
@@ -242,38 +240,63 @@ static int SubtlextTagFind(VALUE value) {
             /* Collect tags and raise if a tag wasn't found. Empty
              * arrays reset tags and never enter this loop */
             for (i = 0; Qnil != (entry = rb_ary_entry(value, i)); ++i) {
-                tags |= SubtlextTagFind(entry);
+                SubtlextTagFind(entry, tags);
             }
         } break;
         default:
             rb_raise(rb_eArgError, "Unexpected value-type `%s'", rb_obj_classname(value));
     }
 
-    return tags;
+    /* Set tag bit */
+    if (0 <= id && TAGSWORDS * 32 - 1 > id) {
+        tags[(id + 1) / 32] |= (1UL << ((id + 1) % 32));
+    }
+} /* }}} */
+
+/* SubtlextTagRequest {{{ */
+static void SubtlextTagRequest(Window win, unsigned long *tags, int nwords) {
+    if (1 < nwords) {
+        XChangeProperty(display, win, XInternAtom(display, "SUBTLE_TAG_REQUEST", False),
+                        XA_CARDINAL, 32, PropModeReplace, (unsigned char *) tags, nwords);
+    }
 } /* }}} */
 
 /* SubtlextTag {{{ */
 static VALUE SubtlextTag(VALUE self, VALUE value, int action) {
+    int i, nwords = 1;
+    unsigned long tags[TAGSWORDS] = {0}, old[TAGSWORDS] = {0};
     SubMessageData data = {{0, 0, 0, 0, 0}};
+    VALUE cur = Qnil;
 
     /* Check ruby object */
     rb_check_frozen(self);
 
     /* Convert tags to bitmask */
-    data.l[1] |= SubtlextTagFind(value);
+    SubtlextTagFind(value, tags);
 
-    /* Get and update tag mask */
-    if (0 != action) {
-        int tags = FIX2INT(rb_iv_get(self, "@tags"));
+    /* Get current tag mask */
+    cur = rb_iv_get(self, "@tags");
+
+    for (i = 0; i < TAGSWORDS; i++) {
+        old[i] = subextSubtlextTagsWord(cur, i);
 
         /* Update masks */
         if (1 == action) {
-            data.l[1] = tags | data.l[1];
+            tags[i] = old[i] | tags[i];
         } else if (-1 == action) {
-            data.l[1] = tags & ~data.l[1];
+            tags[i] = old[i] & ~tags[i];
+        }
+
+        /* Send words up to the highest changed or used one */
+        if (0 != old[i] || 0 != tags[i]) {
+            nwords = i + 1;
         }
     }
 
+    /* Larger sets don't fit into a message and are passed as property */
+    data.l[1] = tags[0];
+    data.l[2] = nwords;
+
     /* Send message based on object type */
     if (rb_obj_is_instance_of(self, rb_const_get(mod, rb_intern("Client")))) {
         VALUE win = Qnil;
@@ -281,6 +304,7 @@ static VALUE SubtlextTag(VALUE self, VALUE value, int action) {
         GET_ATTR(self, "@win", win);
         data.l[0] = NUM2LONG(win);
 
+        SubtlextTagRequest(NUM2LONG(win), tags, nwords);
         subSharedMessage(display, ROOT, "SUBTLE_CLIENT_TAGS", data, 32, True);
     } else {
         VALUE id = Qnil;
@@ -288,6 +312,7 @@ static VALUE SubtlextTag(VALUE self, VALUE value, int action) {
         GET_ATTR(self, "@id", id);
         data.l[0] = FIX2LONG(id);
 
+        SubtlextTagRequest(ROOT, tags, nwords);
         subSharedMessage(display, ROOT, "SUBTLE_VIEW_TAGS", data, 32, True);
     }
 
@@ -325,8 +350,8 @@ static VALUE SubtlextTagWriter(VALUE self, VALUE value) {
 
 static VALUE SubtlextTagReader(VALUE self) {
     char **tags = NULL;
-    int i, ntags = 0, value_tags = 0;
-    VALUE method = Qnil, klass = Qnil, t = Qnil;
+    int i, ntags = 0;
+    VALUE method = Qnil, klass = Qnil, t = Qnil, value_tags = Qnil;
     VALUE array = rb_ary_new();
 
     /* Check ruby object */
@@ -335,13 +360,13 @@ static VALUE SubtlextTagReader(VALUE self) {
     /* Fetch data */
     method = rb_intern("new");
     klass = rb_const_get(mod, rb_intern("Tag"));
-    value_tags = FIX2INT(rb_iv_get(self, "@tags"));
+    value_tags = rb_iv_get(self, "@tags");
 
     /* Check results */
     if ((tags = subSharedPropertyGetStrings(
                  display, ROOT, XInternAtom(display, "SUBTLE_TAG_LIST", False), &ntags))) {
         for (i = 0; i < ntags; i++) {
-            if (value_tags & (1L << (i + 1))) {
+            if (subextSubtlextTagsWord(value_tags, (i + 1) / 32) & (1UL << ((i + 1) % 32))) {
                 /* Create new tag */
                 t = rb_funcall(klass, method, 1, rb_str_new2(tags[i]));
                 rb_iv_set(t, "@id", INT2FIX(i));
@@ -426,7 +451,9 @@ static VALUE SubtlextTagAsk(VALUE self, VALUE value) {
         id = rb_iv_get(tag, "@id");
         tags = rb_iv_get(self, "@tags");
 
-        if (FIX2INT(tags) & (1L << (FIX2INT(id) + 1))) {
+        if (subextSubtlextTagsWord(tags, (FIX2INT(id) + 1) / 32)
+            & (1UL << ((FIX2INT(id) + 1) % 32)))
+        {
             ret = Qtrue;
         }
     }
@@ -1624,6 +1651,86 @@ VALUE subextSubtlextFindObjectsGeometry(char *prop_name, char *class_name, char
     return ret;
 } /* }}} */
 
+/** subextSubtlextTagsToValue {{{
+ * @brief Convert tag set words to integer
+ * @param[in]  words   Tag set words
+ * @param[in]  nwords  Number of words
+ * @return Integer with all tag bits
+ **/
+
+VALUE subextSubtlextTagsToValue(unsigned long *words, int nwords) {
+    int i, used = False;
+    VALUE value = INT2FIX(0);
+
+    /* Assemble integer from most significant word down */
+    for (i = (TAGSWORDS < nwords ? TAGSWORDS : nwords) - 1; words && 0 <= i; i--) {
+        if (used || 0 != (words[i] & 0xffffffff)) {
+            used = True;
+            value = rb_funcall(value, rb_intern("<<"), 1, INT2FIX(32));
+            value = rb_funcall(value, rb_intern("|"), 1, ULONG2NUM(words[i] & 0xffffffff));
+        }
+    }
+
+    return value;
+} /* }}} */
+
+/** subextSubtlextTagsWord {{{
+ * @brief Get word of tag set integer
+ * @param[in]  value  Tag set integer
+ * @param[in]  word   Word index
+ * @return Word of tag set
+ **/
+
+unsigned long subextSubtlextTagsWord(VALUE value, int word) {
+    /* Fast path for plain fixnums */
+    if (FIXNUM_P(value) && 0 == word) {
+        return FIX2LONG(value) & 0xffffffff;
+    } else if (FIXNUM_P(value) || T_BIGNUM == rb_type(value)) {
+        value = rb_funcall(value, rb_intern(">>"), 1, INT2FIX(32 * word));
+        value = rb_funcall(value, rb_intern("&"), 1, ULONG2NUM(0xffffffff));
+
+        return NUM2ULONG(value);
+    }
+
+    return 0;
+} /* }}} */
+
+/** subextSubtlextTagsCheck {{{
+ * @brief Check if tag is in tag set words
+ * @param[in]  words   Tag set words
+ * @param[in]  nwords  Number of words
+ * @param[in]  id      Tag or view id
+ * @retval  1  Tag is set
+ * @retval  0  Tag is not set
+ **/
+
+int subextSubtlextTagsCheck(unsigned long *words, int nwords, int id) {
+    int bit = id + 1;
+
+    return words && 0 <= id && bit / 32 < nwords && !!(words[bit / 32] & (1UL << (bit % 32)));
+} /* }}} */
+
+/** subextSubtlextTagsMatch {{{
+ * @brief Check if two tag sets share any tag
+ * @param[in]  a   Tag set words
+ * @param[in]  na  Number of words of a
+ * @param[in]  b   Tag set words
+ * @param[in]  nb  Number of words of b
+ * @retval  1  Sets share tags
+ * @retval  0  Sets are disjoint
+ **/
+
+int subextSubtlextTagsMatch(unsigned long *a, int na, unsigned long *b, int nb) {
+    int i;
+    unsigned long any = 0;
+
+    for (i = 0; a && b && i < na && i < nb; i++) {
+        any |= a[i] & b[i];
+    }
+
+    return 0 != (any & 0xffffffff);
+} /* }}} */
+
 /* Plugin */
 
 /* Init_subtlext {{{ */
@@ -221,6 +221,11 @@ VALUE subextSubtlextFindWindows(char *prop_name, char *class_name, char *source,
                                 int first); ///< Find objects
 VALUE subextSubtlextFindObjectsGeometry(char *prop_name, char *class_name, char *source, int flags,
                                         int first); ///< Find objects with geometries
+VALUE subextSubtlextTagsToValue(unsigned long *words, int nwords); ///< Convert tag words
+unsigned long subextSubtlextTagsWord(VALUE value, int word); ///< Get word of tags
+int subextSubtlextTagsCheck(unsigned long *words, int nwords, int id); ///< Check tag in words
+int subextSubtlextTagsMatch(unsigned long *a, int na, unsigned long *b,
+                            int nb); ///< Check for common tags
 /* }}} */
 
 /* tag.c {{{ */
@@ -115,7 +115,7 @@ VALUE subextTagSingFirst(VALUE self, VALUE value) {
 VALUE subextTagSingVisible(VALUE self) {
     int i, ntags = 0;
     char **tags = NULL;
-    unsigned long *visible = NULL;
+    unsigned long *visible = NULL, nvisible = 0;
     VALUE meth = Qnil, klass = Qnil, array = Qnil, t = Qnil;
 
     subextSubtlextConnect(NULL); ///< Implicit open connection
@@ -128,13 +128,13 @@ VALUE subextTagSingVisible(VALUE self) {
                                        XInternAtom(display, "SUBTLE_TAG_LIST", False), &ntags);
     visible = (unsigned long *) subSharedPropertyGet(
             display, DefaultRootWindow(display), XA_CARDINAL,
-            XInternAtom(display, "SUBTLE_VISIBLE_TAGS", False), NULL);
+            XInternAtom(display, "SUBTLE_VISIBLE_TAGS", False), &nvisible);
 
     /* Populate array */
     if (tags && visible) {
         for (i = 0; i < ntags; i++) {
             /* Create tag on match */
-            if (*visible & (1L << (i + 1))
+            if (subextSubtlextTagsCheck(visible, nvisible, i)
                 && !NIL_P(t = rb_funcall(klass, meth, 1, rb_str_new2(tags[i]))))
             {
                 rb_iv_set(t, "@id", INT2FIX(i));
@@ -308,7 +308,7 @@ VALUE subextTagSave(VALUE self) {
 VALUE subextTagClients(VALUE self) {
     int i, nclients = 0;
     Window *clients = NULL;
-    unsigned long *tags = NULL;
+    unsigned long *tags = NULL, ntags = 0;
     VALUE id = Qnil, array = Qnil, klass = Qnil, meth = Qnil, c = Qnil;
 
     /* Check ruby object */
@@ -326,10 +326,10 @@ VALUE subextTagClients(VALUE self) {
         for (i = 0; i < nclients; i++) {
             if ((tags = (unsigned long *) subSharedPropertyGet(
                          display, clients[i], XA_CARDINAL,
-                         XInternAtom(display, "SUBTLE_CLIENT_TAGS", False), NULL)))
+                         XInternAtom(display, "SUBTLE_CLIENT_TAGS", False), &ntags)))
             {
                 /* Check if tag id matches */
-                if (*tags & (1L << (FIX2INT(id) + 1))) {
+                if (subextSubtlextTagsCheck(tags, ntags, FIX2INT(id))) {
                     /* Create new client */
                     if (!NIL_P(c = rb_funcall(klass, meth, 1, LONG2NUM(clients[i])))) {
                         subextClientUpdate(c);
@@ -337,6 +337,8 @@ VALUE subextTagClients(VALUE self) {
                         rb_ary_push(array, c);
                     }
                 }
+
+                free(tags);
             }
         }
 
@@ -362,7 +364,7 @@ VALUE subextTagClients(VALUE self) {
 VALUE subextTagViews(VALUE self) {
     int i, nnames = 0;
     char **names = NULL;
-    unsigned long *tags = NULL;
+    unsigned long *tags = NULL, ntags = 0;
     VALUE id = Qnil, array = Qnil, klass = Qnil, meth = Qnil, v = Qnil;
 
     /* Check ruby object */
@@ -379,13 +381,15 @@ VALUE subextTagViews(VALUE self) {
                                         XInternAtom(display, "_NET_DESKTOP_NAMES", False), &nnames);
     tags = (unsigned long *) subSharedPropertyGet(display, DefaultRootWindow(display), XA_CARDINAL,
                                                   XInternAtom(display, "SUBTLE_VIEW_TAGS", False),
-                                                  NULL);
+                                                  &ntags);
 
     /* Check results */
-    if (names && tags) {
+    if (names && tags && 0 < nnames) {
+        int nwords = ntags / nnames; ///< Words per view
+
         for (i = 0; i < nnames; i++) {
             /* Check if tag id matches */
-            if (tags[i] & (1L << (FIX2INT(id) + 1))) {
+            if (subextSubtlextTagsCheck(tags + i * nwords, nwords, FIX2INT(id))) {
                 /* Create new view */
                 if (!NIL_P(v = rb_funcall(klass, meth, 1, rb_str_new2(names[i])))) {
                     rb_iv_set(v, "@id", INT2FIX(i));
@@ -12,6 +12,36 @@
 
 #include "subtlext.h"
 
+/* ViewTags {{{ */
+static unsigned long *ViewTags(int *nwords, int *ntagged) {
+    unsigned long *tags = NULL, *nviews = NULL, ntags = 0;
+
+    *nwords = 1;
+    *ntagged = 0;
+
+    /* Fetch view tags and derive words per view from their count */
+    if ((tags = (unsigned long *) subSharedPropertyGet(
+                 display, ROOT, XA_CARDINAL, XInternAtom(display, "SUBTLE_VIEW_TAGS", False),
+                 &ntags)))
+    {
+        if ((nviews = (unsigned long *) subSharedPropertyGet(
+                     display, ROOT, XA_CARDINAL,
+                     XInternAtom(display, "_NET_NUMBER_OF_DESKTOPS", False), NULL)))
+        {
+            if (0 < *nviews && *nviews <= ntags) {
+                *nwords = ntags / *nviews;
+            }
+
+            free(nviews);
+        }
+
+        /* Views actually covered by the property */
+        *ntagged = ntags / *nwords;
+    }
+
+    return tags;
+} /* }}} */
+
 /* ViewSelect {{{ */
 static VALUE ViewSelect(VALUE self, int dir) {
     int nnames = 0;
@@ -146,10 +176,9 @@ VALUE subextViewSingFirst(VALUE self, VALUE value) {
  */
 
 VALUE subextViewSingCurrent(VALUE self) {
-    int nnames = 0;
+    int nnames = 0, nwords = 1, ntagged = 0;
     char **names = NULL;
-    long *tags = NULL;
-    unsigned long *cur_view = NULL;
+    unsigned long *tags = NULL, *cur_view = NULL;
     VALUE view = Qnil;
 
     subextSubtlextConnect(NULL); ///< Implicit open connection
@@ -160,16 +189,15 @@ VALUE subextViewSingCurrent(VALUE self) {
     cur_view = (unsigned long *) subSharedPropertyGet(
             display, DefaultRootWindow(display), XA_CARDINAL,
             XInternAtom(display, "_NET_CURRENT_DESKTOP", False), NULL);
-    tags = (long *) subSharedPropertyGet(display, ROOT, XA_CARDINAL,
-                                         XInternAtom(display, "SUBTLE_VIEW_TAGS", False), NULL);
+    tags = ViewTags(&nwords, &ntagged);
 
     /* Check results */
-    if (names && cur_view && tags) {
+    if (names && cur_view && tags && *cur_view < nnames && *cur_view < ntagged) {
         /* Create instance */
         view = subextViewInstantiate(names[*cur_view]);
 
         rb_iv_set(view, "@id", INT2FIX(*cur_view));
-        rb_iv_set(view, "@tags", LONG2NUM(tags[*cur_view]));
+        rb_iv_set(view, "@tags", subextSubtlextTagsToValue(tags + *cur_view * nwords, nwords));
     }
 
     if (names) {
@@ -199,9 +227,9 @@ VALUE subextViewSingCurrent(VALUE self) {
  */
 
 VALUE subextViewSingVisible(VALUE self) {
-    int i, nnames = 0, *tags = NULL;
+    int i, nnames = 0, nwords = 1, ntagged = 0;
     char **names = NULL;
-    unsigned long *visible = NULL;
+    unsigned long *visible = NULL, *tags = NULL, nvisible = 0;
     VALUE meth = Qnil, klass = Qnil, array = Qnil, v = Qnil;
 
     subextSubtlextConnect(NULL); ///< Implicit open connection
@@ -214,19 +242,18 @@ VALUE subextViewSingVisible(VALUE self) {
                                         XInternAtom(display, "_NET_DESKTOP_NAMES", False), &nnames);
     visible = (unsigned long *) subSharedPropertyGet(
             display, DefaultRootWindow(display), XA_CARDINAL,
-            XInternAtom(display, "SUBTLE_VISIBLE_VIEWS", False), NULL);
-    tags = (int *) subSharedPropertyGet(display, ROOT, XA_CARDINAL,
-                                        XInternAtom(display, "SUBTLE_VIEW_TAGS", False), NULL);
+            XInternAtom(display, "SUBTLE_VISIBLE_VIEWS", False), &nvisible);
+    tags = ViewTags(&nwords, &ntagged);
 
     /* Check results */
     if (names && visible && tags) {
-        for (i = 0; i < nnames; i++) {
+        for (i = 0; i < nnames && i < ntagged; i++) {
             /* Create view on match */
-            if (*visible & (1L << (i + 1))
+            if (subextSubtlextTagsCheck(visible, nvisible, i)
                 && !NIL_P(v = rb_funcall(klass, meth, 1, rb_str_new2(names[i]))))
             {
                 rb_iv_set(v, "@id", INT2FIX(i));
-                rb_iv_set(v, "@tags", INT2FIX(tags[i]));
+                rb_iv_set(v, "@tags", subextSubtlextTagsToValue(tags + i * nwords, nwords));
 
                 rb_ary_push(array, v);
             }
@@ -261,8 +288,8 @@ VALUE subextViewSingVisible(VALUE self) {
  */
 
 VALUE subextViewSingList(VALUE self) {
-    int i, nnames = 0;
-    long *tags = NULL;
+    int i, nnames = 0, nwords = 1, ntagged = 0;
+    unsigned long *tags = NULL;
     char **names = NULL;
     VALUE meth = Qnil, klass = Qnil, array = Qnil, v = Qnil;
 
@@ -274,15 +301,14 @@ VALUE subextViewSingList(VALUE self) {
     array = rb_ary_new();
     names = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
                                         XInternAtom(display, "_NET_DESKTOP_NAMES", False), &nnames);
-    tags = (long *) subSharedPropertyGet(display, ROOT, XA_CARDINAL,
-                                         XInternAtom(display, "SUBTLE_VIEW_TAGS", False), NULL);
+    tags = ViewTags(&nwords, &ntagged);
 
     /* Check results */
     if (names && tags) {
-        for (i = 0; i < nnames; i++) {
+        for (i = 0; i < nnames && i < ntagged; i++) {
             if (!NIL_P(v = rb_funcall(klass, meth, 1, rb_str_new2(names[i])))) {
                 rb_iv_set(v, "@id", INT2FIX(i));
-                rb_iv_set(v, "@tags", LONG2NUM(tags[i]));
+                rb_iv_set(v, "@tags", subextSubtlextTagsToValue(tags + i * nwords, nwords));
 
                 rb_ary_push(array, v);
             }
@@ -354,7 +380,8 @@ VALUE subextViewInit(VALUE self, VALUE name) {
  */
 
 VALUE subextViewUpdate(VALUE self) {
-    long *tags = NULL, ntags = 0;
+    int nwords = 1, ntagged = 0;
+    unsigned long *tags = NULL;
     VALUE id = Qnil;
 
     /* Check ruby object */
@@ -364,13 +391,13 @@ VALUE subextViewUpdate(VALUE self) {
     subextSubtlextConnect(NULL); ///< Implicit open connection
 
     /* Fetch tags */
-    if ((tags = (long *) subSharedPropertyGet(display, ROOT, XA_CARDINAL,
-                                              XInternAtom(display, "SUBTLE_VIEW_TAGS", False),
-                                              (unsigned long *) &ntags)))
-    {
+    if ((tags = ViewTags(&nwords, &ntagged))) {
         int idx = FIX2INT(id);
 
-        rb_iv_set(self, "@tags", LONG2NUM(idx < ntags ? tags[idx] : 0));
+        /* Check view bounds */
+        rb_iv_set(self, "@tags",
+                  0 <= idx && idx < ntagged ? subextSubtlextTagsToValue(tags + idx * nwords, nwords)
+                                            : INT2FIX(0));
 
         free(tags);
     }
@@ -453,6 +480,7 @@ VALUE subextViewClients(VALUE self) {
     Window *clients = NULL;
     VALUE id = Qnil, klass = Qnil, meth = Qnil, array = Qnil, client = Qnil;
     unsigned long *view_tags = NULL;
+    int nwords = 1, ntagged = 0;
 
     /* Check ruby object */
     rb_check_frozen(self);
@@ -465,25 +493,25 @@ VALUE subextViewClients(VALUE self) {
     meth = rb_intern("new");
     array = rb_ary_new();
     clients = subextSubtlextWindowList("_NET_CLIENT_LIST", &nclients);
-    view_tags = (unsigned long *) subSharedPropertyGet(
-            display, DefaultRootWindow(display), XA_CARDINAL,
-            XInternAtom(display, "SUBTLE_VIEW_TAGS", False), NULL);
+    view_tags = ViewTags(&nwords, &ntagged);
 
     /* Check results */
-    if (clients && view_tags) {
+    if (clients && view_tags && 0 <= FIX2INT(id) && FIX2INT(id) < ntagged) {
         for (i = 0; i < nclients; i++) {
-            unsigned long *client_tags = NULL, *flags = NULL;
+            unsigned long *client_tags = NULL, *flags = NULL, nclient_tags = 0;
 
             /* Fetch window data */
             client_tags = (unsigned long *) subSharedPropertyGet(
                     display, clients[i], XA_CARDINAL,
-                    XInternAtom(display, "SUBTLE_CLIENT_TAGS", False), NULL);
+                    XInternAtom(display, "SUBTLE_CLIENT_TAGS", False), &nclient_tags);
             flags = (unsigned long *) subSharedPropertyGet(
                     display, clients[i], XA_CARDINAL,
                     XInternAtom(display, "SUBTLE_CLIENT_FLAGS", False), NULL);
 
             /* Check if there are common tags or window is stick */
-            if ((client_tags && view_tags[FIX2INT(id)] & *client_tags)
+            if ((client_tags
+                 && subextSubtlextTagsMatch(view_tags + FIX2INT(id) * nwords, nwords, client_tags,
+                                            nclient_tags))
                 || (flags && *flags & SUB_EWMH_STICK))
             {
                 if (RTEST(client = rb_funcall(klass, meth, 1, LONG2NUM(clients[i])))) {
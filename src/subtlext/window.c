@@ -49,6 +49,7 @@ static void WindowSweep(SubtlextWindow *w) {
     if (w) {
         /* Destroy window */
         if (!(w->flags & WINDOW_FOREIGN_WIN)) {
+            subSharedDrawForget(display, w->win);
             XDestroyWindow(display, w->win);
         }
 
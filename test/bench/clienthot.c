@@ -0,0 +1,145 @@
+/**
+ * @package subtle
+ *
+ * @file Client hot state benchmark
+ * @copyright 2005-present Christoph Kappel <christoph@unexist.dev>
+ * @version $Id$
+ *
+ * This program can be distributed under the terms of the GNU GPLv2.
+ * See the file COPYING for details.
+ *
+ * Compares the gravity member count of ClientTile via the shipped
+ * subClientHotCount over the hot arrays against chasing the scattered
+ * client structs, at 1k and 10k clients.
+ *
+ * Build: cc -O2 -I. -Isrc/shared -Isrc/subtle $(pkg-config --cflags xft) \
+ *          $(ruby -e 'puts RbConfig::CONFIG.values_at("rubyhdrdir", "rubyarchhdrdir")
+ *                         .map { |d| "-I" + d }.join(" ")') \
+ *          -o clienthot test/bench/clienthot.c
+ * Run:   ./clienthot (needs a configured tree for config.h)
+ **/
+
+#include <time.h>
+#include "subtle.h"
+
+#define ROUNDS 1000
+
+SubSubtle *subtle = NULL;
+
+/* BenchNow {{{ */
+static double BenchNow(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+} /* }}} */
+
+/* BenchChase {{{ */
+static int BenchChase(SubClient **clients, int nclients, int gravityid, int screenid) {
+    int i, used = 0;
+
+    /* Like the scan over the client array before the hot state */
+    for (i = 0; i < nclients; i++) {
+        SubClient *c = clients[i];
+
+        if (c->gravityid == gravityid && c->screenid == screenid
+            && subTagsMatch(&subtle->visible_tags, &c->tags)
+            && !(c->flags & (SUB_CLIENT_MODE_FLOAT | SUB_CLIENT_MODE_FULL)))
+        {
+            used++;
+        }
+    }
+
+    return used;
+} /* }}} */
+
+/* BenchRun {{{ */
+static void BenchRun(int nclients) {
+    int i, r, chased = 0, counted = 0;
+    double start = 0, chase = 0, hot = 0;
+    SubClient **clients = NULL;
+
+    clients = (SubClient **) calloc(nclients, sizeof(SubClient *));
+
+    subtle->hot.size = subtle->hot.nentries = nclients;
+    subtle->hot.clients = clients;
+    subtle->hot.flags = (FLAGS *) calloc(nclients, sizeof(FLAGS));
+    subtle->hot.tags = (TAGS *) calloc(nclients, sizeof(TAGS));
+    subtle->hot.screenids = (int *) calloc(nclients, sizeof(int));
+    subtle->hot.gravityids = (int *) calloc(nclients, sizeof(int));
+
+    /* Scatter clients on the heap like real ones and mirror them like ClientHotAdd */
+    for (i = 0; i < nclients; i++) {
+        SubClient *c = NULL;
+
+        free(malloc(rand() % 512));
+
+        c = clients[i] = (SubClient *) calloc(1, sizeof(SubClient));
+        c->flags = rand() % 8 ? 0 : SUB_CLIENT_MODE_FLOAT;
+        c->screenid = rand() % 2;
+        c->gravityid = rand() % 9;
+        c->slot = i;
+
+        subTagsSet(&c->tags, rand() % 40);
+
+        subtle->hot.flags[i] = c->flags;
+        subtle->hot.tags[i] = c->tags;
+        subtle->hot.screenids[i] = c->screenid;
+        subtle->hot.gravityids[i] = c->gravityid;
+    }
+
+    /* Pointer chasing */
+    start = BenchNow();
+
+    for (r = 0; r < ROUNDS; r++) {
+        chased += BenchChase(clients, nclients, r % 9, 0);
+    }
+
+    chase = BenchNow() - start;
+
+    /* Hot arrays */
+    start = BenchNow();
+
+    for (r = 0; r < ROUNDS; r++) {
+        counted += subClientHotCount(r % 9, 0);
+    }
+
+    hot = BenchNow() - start;
+
+    printf("%6d clients: chase %8.3f ms, hot %8.3f ms, %.1fx (%s)\n", nclients,
+           chase * 1000.0, hot * 1000.0, chase / hot, chased == counted ? "ok" : "mismatch");
+
+    /* Tidy up */
+    for (i = 0; i < nclients; i++) {
+        free(clients[i]);
+    }
+
+    free(clients);
+    free(subtle->hot.flags);
+    free(subtle->hot.tags);
+    free(subtle->hot.screenids);
+    free(subtle->hot.gravityids);
+} /* }}} */
+
+int main(void) {
+    int i;
+
+    subtle = (SubSubtle *) calloc(1, sizeof(SubSubtle));
+
+    /* First quarter of the tags is visible */
+    for (i = 0; i < 10; i++) {
+        subTagsSet(&subtle->visible_tags, i);
+    }
+
+    srand(42);
+
+    BenchRun(1000);
+    BenchRun(10000);
+
+    free(subtle);
+
+    return 0;
+}
+
+// vim:ts=2:bs=2:sw=2:et:fdm=marker
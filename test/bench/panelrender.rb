@@ -0,0 +1,102 @@
+#!/usr/bin/ruby
+#
+# @package test
+#
+# @file Benchmark panel rendering
+# @author Christoph Kappel <christroph@unexist.dev>
+# @version $Id$
+#
+# This program can be distributed under the terms of the GNU GPLv2.
+# See the file COPYING for details.
+#
+# Drives subScreenRender and subScreenFlush of a running subtle under
+# Xvfb by switching views and reads requests and time per frame from
+# the render log. Needs a debug build (rake debug=yes).
+#
+# Run: ruby test/bench/panelrender.rb
+#
+
+require "mkmf"
+
+# Configuration
+base    = File.expand_path("../..", __dir__)
+subtle  = File.join(base, "subtle")
+config  = File.join(base, "data", "subtle.rb")
+display = ":10"
+rounds  = 500
+
+require File.join(base, "subtlext.so")
+
+# Find Xvfb
+if (xvfb = find_executable0("Xvfb")).nil?
+  raise "Xvfb not found in path"
+end
+
+xserver = Process.spawn("#{xvfb} #{display} -screen 0 1024x768x16 -I",
+  [ :out, :err ] => "/dev/null")
+
+sleep 1
+
+# Start subtle and collect render log lines
+log   = IO.popen([ subtle, "-d", display, "-c", config, "-l", "subtle",
+  :err => [ :child, :out ] ])
+stats = Queue.new
+
+reader = Thread.new do
+  log.each_line do |line|
+    if (m = line.match(/Render: spans=(\d+), pixels=(\d+), requests=(\d+), usecs=(\d+)/))
+      stats << m.captures.map(&:to_i)
+    end
+  end
+end
+
+sleep 1
+
+begin
+  Subtlext::Subtle.display = display
+
+  views = Subtlext::View.all
+
+  raise "Need at least two views" if 2 > views.size
+
+  # Drop frames of startup
+  stats.pop until stats.empty?
+
+  # Each jump damages the views panel and schedules one frame
+  start = Time.now
+
+  rounds.times do |i|
+    views[i % 2].jump
+    Subtlext::Subtle.render
+
+    sleep 0.01
+  end
+
+  sleep 1
+
+  elapsed = Time.now - start
+  frames  = []
+
+  frames << stats.pop until stats.empty?
+
+  # Skip frames without damage
+  frames.reject! { |f| 0 == f[0] }
+
+  raise "No render log, is subtle built with debug=yes?" if frames.empty?
+
+  # Print results
+  puts "frames:   %d in %.2fs" % [ frames.size, elapsed ]
+
+  [ "spans", "pixels", "requests", "usecs" ].each_with_index do |name, i|
+    values = frames.map { |f| f[i] }.sort
+
+    puts "%-9s avg=%.1f median=%d max=%d" % [ name + ":",
+      values.sum.to_f / values.size, values[values.size / 2], values.last ]
+  end
+ensure
+  Process.kill("TERM", log.pid) rescue nil
+  reader.join(1)
+  Process.kill("TERM", xserver) rescue nil
+end
+
+# vim:ts=2:bs=2:sw=2:et:fdm=marker
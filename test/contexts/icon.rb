@@ -43,7 +43,7 @@ context 'Icon' do
   end # }}}
 
   asserts 'Convert to string' do # {{{
-    topic.to_str.match(/<>![0-9]+<>/)
+    topic.to_str.match(/<>![0-9]+:[0-9]+x[0-9]+<>/)
   end # }}}
 end
 
@@ -84,6 +84,44 @@ context 'Tag' do
 
     TAG_COUNT == Subtlext::Tag.all.size
   end # }}}
+
+  asserts 'Tag sets wider than one word' do # {{{
+    client = Subtlext::Client.current
+    view   = Subtlext::View.current
+    ctags  = client.tags
+    vtags  = view.tags
+
+    # Create enough tags to span several words
+    names = (0...40).map { |i| 'wide%d' % [ i ] }
+    names.each { |name| Subtlext::Tag.new(name).save }
+
+    sleep 1
+
+    # Set whole sets at once
+    wide        = names.map { |name| Subtlext::Tag.first(name) }
+    client.tags = wide
+    view.tags   = wide
+
+    sleep 0.5
+
+    # Compare round-tripped sets
+    cwide = client.tags.map(&:name).sort
+    vwide = view.tags.map(&:name).sort
+
+    # Restore sets and remove tags
+    client.tags = ctags
+    view.tags   = vtags
+
+    sleep 0.5
+
+    wide.each(&:kill)
+
+    sleep 1
+
+    names.sort == cwide and names.sort == vwide and
+      ctags == client.tags and vtags == view.tags and
+      TAG_COUNT == Subtlext::Tag.all.size
+  end # }}}
 end
 
 # vim:ts=2:bs=2:sw=2:et:fdm=marker